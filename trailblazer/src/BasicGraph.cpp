@@ -16,6 +16,7 @@
 
 #include <sstream>
 #include "BasicGraph.h"
+#include "trailblazergui.h"
 
 /*
  * Node member implementations
@@ -23,12 +24,15 @@
 
 Grid<double>* Node::s_world = nullptr;
 double (* Node::s_heuristicFunction)(Node* const from, Node* const to, const Grid<double>& world) = nullptr;
+unsigned long long Node::s_generation = 0;
+double Node::s_initialCost = 0.0;
 
 Node::Node(string name, int row, int col, double gridValue) {
     this->name = name;
     this->m_row = row;
     this->m_col = col;
     this->m_gridValue = gridValue;
+    this->m_generation = s_generation;
     this->resetData();
 }
 
@@ -51,6 +55,14 @@ void Node::resetData() {
     this->m_color = WHITE;
 }
 
+void Node::refresh() {
+    if (this->m_generation != s_generation) {
+        this->m_generation = s_generation;
+        this->resetData();
+        this->cost = s_initialCost;
+    }
+}
+
 void Node::setColor(Color c) {
     this->m_color = c;
     if (s_world != nullptr) {
@@ -66,6 +78,11 @@ void Node::setWorld(const Grid<double>& world) {
     s_world = const_cast<Grid<double>*>(&world);
 }
 
+void Node::beginGeneration(double initialCost) {
+    s_generation++;
+    s_initialCost = initialCost;
+}
+
 string Node::toString() const {
     ostringstream out;
     out << *this;
@@ -188,6 +205,10 @@ void BasicGraph::resetData() {
     }
 }
 
+void BasicGraph::beginSearch(double initialCost) {
+    Node::beginGeneration(initialCost);
+}
+
 
 // members below are just mirrors of ones from Graph
 
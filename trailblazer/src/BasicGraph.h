@@ -21,7 +21,7 @@
 #include "graph.h"
 #include "grid.h"
 #include "set.h"
-#include "trailblazergui.h"
+#include "types.h"
 using namespace std;
 
 /*
@@ -85,6 +85,15 @@ public:
      */
     void resetData();
 
+    /*
+     * Brings the supplementary data of this vertex up to date with the search
+     * started by the latest call to BasicGraph::beginSearch.  If the vertex has
+     * not been touched since then, its data is wiped as by resetData, except
+     * that cost is set to the initial cost passed to beginSearch.
+     * Call this before reading the data of a vertex during a search.
+     */
+    void refresh();
+
     /*
      * Sets the color of this vertex to be the given color.
      * The color must be one of WHITE, GRAY, YELLOW, or GREEN.
@@ -105,9 +114,13 @@ public:
      */
     static void setHeuristicFunction(double (* func)(Node* const from, Node* const to, const Grid<double>& world));
     static void setWorld(const Grid<double>& world);
+    static void beginGeneration(double initialCost);
 
 private:
     Color m_color;   // node's color as passed to setColor
+    unsigned long long m_generation;   // search the supplementary data belongs to
+    static unsigned long long s_generation;
+    static double s_initialCost;
     static double (* s_heuristicFunction)(Node* const from, Node* const to,
                                           const Grid<double>& world);
     static Grid<double>* s_world;
@@ -205,6 +218,14 @@ public:
     bool isNeighbor(Node* v1, Node* v2) const;
     void resetData();
 
+    /*
+     * Starts a new search in constant time.  Instead of wiping every vertex
+     * up front as resetData does, each vertex is wiped lazily the first time
+     * refresh is called on it during the search, and its cost starts out as
+     * the given initial cost.  Arc data is not affected.
+     */
+    void beginSearch(double initialCost = 0.0);
+
     /*
      * The members below are mirrors of ones from Graph but with 'Node' changed
      * to 'Vertex' and/or 'Arc' changed to 'Edge', with identical behavior,
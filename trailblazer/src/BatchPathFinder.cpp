@@ -0,0 +1,187 @@
+/**
+ * Defines the BatchPathFinder class
+ * @file BatchPathFinder.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <cmath>
+#include "BatchPathFinder.h"
+
+using namespace std;
+
+/**
+ * Starts the worker threads
+ * @param graph The graph to search on; must outlive the path finder
+ * @param world The world passed to the heuristic; must outlive the path finder
+ * @param heuristicFn The estimate of the remaining cost, or nullptr to run Dijkstra's algorithm
+ * @param numThreads The number of worker threads, or 0 for one per hardware thread
+ */
+BatchPathFinder::BatchPathFinder(const CompactGraph& graph, const Grid<double>& world,
+                                 double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                 int numThreads)
+    : m_graph(graph), m_world(world), m_heuristicFn(heuristicFn) {
+    m_batch = 0;
+    m_activeWorkers = 0;
+    m_stopping = false;
+    m_numJobs = 0;
+    m_nextJob = 0;
+    m_queries = nullptr;
+    m_results = nullptr;
+    m_sources = nullptr;
+    m_targets = nullptr;
+    m_matrix = nullptr;
+    m_numTargets = 0;
+
+    if (numThreads <= 0)
+        numThreads = max(1u, thread::hardware_concurrency());
+    for (int i = 0; i < numThreads; i++)
+        m_workers.push_back(thread(&BatchPathFinder::work, this));
+}
+
+/**
+ * Stops and joins the worker threads
+ */
+BatchPathFinder::~BatchPathFinder() {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_batchStarted.notify_all();
+    for (thread& worker : m_workers)
+        worker.join();
+}
+
+/**
+ * Answers a batch of path queries, spreading them over the worker threads
+ * @param queries The start and end location of each query
+ * @param results Receives the answer to each query, in the same order
+ */
+void BatchPathFinder::findPaths(const Vector<TBEdge>& queries, Vector<PathResult>& results) {
+    results = Vector<PathResult>(queries.size());
+    if (queries.isEmpty())
+        return;
+
+    m_queries = &queries;
+    m_results = &results;
+    runBatch(queries.size());
+    m_queries = nullptr;
+    m_results = nullptr;
+}
+
+/**
+ * Computes the cost of the cheapest path from every source to every target,
+ * spreading the sources over the worker threads
+ * @param sources The locations to find the paths from
+ * @param targets The locations to find the paths to
+ * @param matrix Receives the costs, with one row per source and one column per
+ * target; INFINITY where there is no path or a location is outside the world
+ */
+void BatchPathFinder::findDistances(const Vector<TBLoc>& sources, const Vector<TBLoc>& targets, Grid<double>& matrix) {
+    matrix.resize(sources.size(), targets.size());
+    if (sources.isEmpty() || targets.isEmpty())
+        return;
+
+    // Each search may stop once it has settled all distinct targets
+    m_isTarget.assign(m_graph.numVertices(), false);
+    m_numTargets = 0;
+    for (const TBLoc& target : targets) {
+        if (m_graph.inBounds(target) && !m_isTarget[m_graph.vertexId(target)]) {
+            m_isTarget[m_graph.vertexId(target)] = true;
+            m_numTargets++;
+        }
+    }
+
+    m_sources = &sources;
+    m_targets = &targets;
+    m_matrix = &matrix;
+    runBatch(sources.size());
+    m_sources = nullptr;
+    m_targets = nullptr;
+    m_matrix = nullptr;
+}
+
+/**
+ * Hands a batch to the worker threads and waits until they are done with it
+ * @param numJobs The number of queries or sources in the batch
+ */
+void BatchPathFinder::runBatch(int numJobs) {
+    unique_lock<mutex> lock(m_mutex);
+    m_numJobs = numJobs;
+    m_nextJob = 0;
+    m_activeWorkers = m_workers.size();
+    m_batch++;
+    m_batchStarted.notify_all();
+
+    m_batchFinished.wait(lock, [this] { return m_activeWorkers == 0; });
+}
+
+/**
+ * The loop of each worker thread: waits for a batch, then takes queries or
+ * sources from it until there are none left
+ */
+void BatchPathFinder::work() {
+    SearchState state(m_graph.numVertices());
+    vector<int> vertices;
+    unsigned int lastBatch = 0;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_batchStarted.wait(lock, [&] { return m_stopping || m_batch != lastBatch; });
+            if (m_stopping)
+                return;
+            lastBatch = m_batch;
+        }
+
+        for (int i = m_nextJob++; i < m_numJobs; i = m_nextJob++) {
+            if (m_queries != nullptr)
+                answer(state, (*m_queries)[i], (*m_results)[i], vertices);
+            else
+                measure(state, i);
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+        if (--m_activeWorkers == 0)
+            m_batchFinished.notify_one();
+    }
+}
+
+/**
+ * Answers a single query
+ * @param state The search state of the calling worker
+ * @param query The start and end location of the path
+ * @param result Receives the path and its cost
+ * @param vertices Scratch space for the vertex ids of the path
+ */
+void BatchPathFinder::answer(SearchState& state, const TBEdge& query, PathResult& result, vector<int>& vertices) {
+    result.path.clear();
+    result.cost = INFINITY;
+    if (!m_graph.inBounds(query.start) || !m_graph.inBounds(query.end))
+        return;
+
+    int end = m_graph.vertexId(query.end);
+    result.cost = compactAStar(m_graph, state, m_graph.vertexId(query.start), end, m_heuristicFn, m_world);
+    state.extractPath(end, vertices);
+    for (int v : vertices)
+        result.path.add(m_graph.location(v));
+}
+
+/**
+ * Fills one row of the distance matrix
+ * @param state The search state of the calling worker
+ * @param source The index of the source whose row to fill
+ */
+void BatchPathFinder::measure(SearchState& state, int source) {
+    const TBLoc& start = (*m_sources)[source];
+    if (m_graph.inBounds(start))
+        compactDijkstra(m_graph, state, m_graph.vertexId(start), m_isTarget, m_numTargets);
+
+    // Workers write disjoint rows, so no locking is needed
+    for (int t = 0; t < m_targets->size(); t++) {
+        const TBLoc& target = (*m_targets)[t];
+        double cost = INFINITY;
+        if (m_graph.inBounds(start) && m_graph.inBounds(target))
+            cost = state.cost(m_graph.vertexId(target));
+        m_matrix->set(source, t, cost);
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * Declares the BatchPathFinder class, which answers many path queries in parallel
+ * @file BatchPathFinder.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef BATCHPATHFINDER_H
+#define BATCHPATHFINDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CompactGraph.h"
+#include "SearchState.h"
+#include "grid.h"
+#include "types.h"
+#include "vector.h"
+
+/*
+ * The answer to one query of a batch: the locations of the path and its cost.
+ * If there is no path, the path is empty and the cost is INFINITY.
+ */
+struct PathResult {
+    Vector<TBLoc> path;
+    double cost;
+};
+
+/*
+ * A pool of worker threads that run A* searches on one shared, read-only
+ * CompactGraph.  Each worker owns a SearchState, so the graph itself is never
+ * written to and any number of queries can be in flight at once.
+ * findDistances fills a matrix of costs between many sources and targets with
+ * one Dijkstra search per source, which stops once every target is settled.
+ * The threads are kept alive between batches; findPaths and findDistances must
+ * not be called from several threads at once.
+ */
+class BatchPathFinder {
+public:
+    BatchPathFinder(const CompactGraph& graph, const Grid<double>& world,
+                    double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                    int numThreads = 0);
+    ~BatchPathFinder();
+
+    int numThreads() const { return m_workers.size(); }
+
+    void findPaths(const Vector<TBEdge>& queries, Vector<PathResult>& results);
+    void findDistances(const Vector<TBLoc>& sources, const Vector<TBLoc>& targets, Grid<double>& matrix);
+
+private:
+    const CompactGraph& m_graph;
+    const Grid<double>& m_world;
+    double (*m_heuristicFn)(TBLoc from, TBLoc to, const Grid<double>& world);
+
+    vector<thread> m_workers;
+    mutex m_mutex;
+    condition_variable m_batchStarted;
+    condition_variable m_batchFinished;
+    unsigned int m_batch;          // number of the batch being worked on
+    int m_activeWorkers;           // workers still busy with the current batch
+    bool m_stopping;
+
+    // the batch being worked on: either path queries or a distance matrix
+    int m_numJobs;
+    atomic<int> m_nextJob;
+    const Vector<TBEdge>* m_queries;
+    Vector<PathResult>* m_results;
+    const Vector<TBLoc>* m_sources;
+    const Vector<TBLoc>* m_targets;
+    Grid<double>* m_matrix;
+    vector<bool> m_isTarget;
+    int m_numTargets;              // number of distinct targets inside the graph
+
+    void runBatch(int numJobs);
+    void work();
+    void answer(SearchState& state, const TBEdge& query, PathResult& result, vector<int>& vertices);
+    void measure(SearchState& state, int source);
+};
+
+#endif // BATCHPATHFINDER_H
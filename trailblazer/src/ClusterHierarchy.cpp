@@ -0,0 +1,342 @@
+/**
+ * Defines the ClusterHierarchy class: building the abstract graph of clusters,
+ * searching it and refining its paths
+ * @file ClusterHierarchy.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include "ClusterHierarchy.h"
+
+using namespace std;
+
+// Entrances at least this long get transitions at both ends and every kTransitionSpacing
+// cells in between, instead of one in the middle
+static const int kWideEntrance = 6;
+static const int kTransitionSpacing = 4;
+
+/**
+ * Cuts the graph into clusters and builds the abstract graph of their transitions
+ * @param graph The graph to search on; must outlive the hierarchy
+ * @param world The world of the graph, passed to the heuristic; must outlive the hierarchy
+ * @param heuristicFn The estimate of the cost between two locations; must never overestimate
+ * @param clusterSize The width and height of a cluster, in cells
+ */
+ClusterHierarchy::ClusterHierarchy(const CompactGraph& graph, const Grid<double>& world,
+                                   double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                   int clusterSize)
+    : m_graph(graph), m_world(world), m_heuristicFn(heuristicFn),
+      m_clusterSize(max(clusterSize, 2)), m_gridState(graph.numVertices()) {
+    int numRows = graph.numRows();
+    int numCols = graph.numCols();
+    int clusterRows = (numRows + m_clusterSize - 1) / m_clusterSize;
+    m_clusterCols = (numCols + m_clusterSize - 1) / m_clusterSize;
+    m_transitionOf.assign(graph.numVertices(), -1);
+    m_clusterTransitions.resize(clusterRows * m_clusterCols);
+
+    // Entrances across the borders between clusters side by side, then one above the other
+    vector<vector<AbstractArc>> arcs;
+    for (int col = m_clusterSize - 1; col + 1 < numCols; col += m_clusterSize) {
+        for (int row = 0; row < numRows; row += m_clusterSize)
+            addEntrances(arcs, graph.vertexId(row, col), graph.vertexId(row, col + 1),
+                         numCols, min(m_clusterSize, numRows - row));
+    }
+    for (int row = m_clusterSize - 1; row + 1 < numRows; row += m_clusterSize) {
+        for (int col = 0; col < numCols; col += m_clusterSize)
+            addEntrances(arcs, graph.vertexId(row, col), graph.vertexId(row + 1, col),
+                         1, min(m_clusterSize, numCols - col));
+    }
+
+    // Arcs between the transitions of each cluster, costed by searches inside it
+    for (const vector<int>& transitions : m_clusterTransitions) {
+        for (int t : transitions) {
+            searchClusters(m_transitions[t], -1, false, clusterOf(m_transitions[t]), clusterOf(m_transitions[t]));
+            for (int u : transitions) {
+                double cost = m_gridState.cost(m_transitions[u]);
+                if (u != t && cost != INFINITY)
+                    arcs[t].push_back({ u, cost });
+            }
+        }
+    }
+
+    m_firstAbstractArc.push_back(0);
+    for (const vector<AbstractArc>& transitionArcs : arcs) {
+        m_abstractArcs.insert(m_abstractArcs.end(), transitionArcs.begin(), transitionArcs.end());
+        m_firstAbstractArc.push_back(m_abstractArcs.size());
+    }
+
+    // The extra abstract vertex numTransitions() stands for the end of a query
+    m_abstractState.resize(numTransitions() + 1);
+    m_startLink.assign(numTransitions(), INFINITY);
+    m_endLink.assign(numTransitions(), INFINITY);
+}
+
+/**
+ * Finds a near-optimal path from one location to another
+ * @param start The location to find the path from
+ * @param end The location to find the path to
+ * @param path Receives the locations of the path, empty if there is none
+ * @return The cost of the path, INFINITY if there is none
+ */
+double ClusterHierarchy::findPath(TBLoc start, TBLoc end, vector<TBLoc>& path) {
+    path.clear();
+    if (!m_graph.inBounds(start) || !m_graph.inBounds(end))
+        return INFINITY;
+
+    int s = m_graph.vertexId(start);
+    int t = m_graph.vertexId(end);
+    int startCluster = clusterOf(s);
+    int endCluster = clusterOf(t);
+
+    // Link the end and the start to the transitions of their clusters
+    searchClusters(t, -1, true, endCluster, endCluster);
+    for (int u : m_clusterTransitions[endCluster])
+        m_endLink[u] = m_gridState.cost(m_transitions[u]);
+    searchClusters(s, -1, false, startCluster, startCluster);
+    for (int u : m_clusterTransitions[startCluster])
+        m_startLink[u] = m_gridState.cost(m_transitions[u]);
+
+    double cost = searchAbstract(startCluster, end);
+    for (int u : m_clusterTransitions[endCluster])
+        m_endLink[u] = INFINITY;
+    for (int u : m_clusterTransitions[startCluster])
+        m_startLink[u] = INFINITY;
+
+    // Nearby ends are often joined better by a path that crosses no transition
+    if (abs(startCluster / m_clusterCols - endCluster / m_clusterCols) <= 1
+            && abs(startCluster % m_clusterCols - endCluster % m_clusterCols) <= 1) {
+        double direct = searchClusters(s, t, false, startCluster, endCluster);
+        if (direct != INFINITY && direct <= cost) {
+            m_gridState.extractPath(t, m_vertices);
+            for (int v : m_vertices)
+                path.push_back(m_graph.location(v));
+            return direct;
+        }
+    }
+    if (cost == INFINITY)
+        return INFINITY;
+
+    // Refine each abstract arc into grid steps
+    path.push_back(start);
+    int current = s;
+    for (int u : m_route) {
+        appendSegment(current, m_transitions[u], path);
+        current = m_transitions[u];
+    }
+    appendSegment(current, t, path);
+    return cost;
+}
+
+/**
+ * Finds the cluster a vertex lies in
+ * @param v The vertex
+ * @return The index of the cluster, counted row by row
+ */
+int ClusterHierarchy::clusterOf(int v) const {
+    int row = v / m_graph.numCols();
+    int col = v % m_graph.numCols();
+    return (row / m_clusterSize) * m_clusterCols + col / m_clusterSize;
+}
+
+/**
+ * Looks up the cost of the arc between two vertices in the graph
+ * @param from The vertex the arc leaves
+ * @param to The vertex the arc enters
+ * @return The cost, INFINITY if there is no such arc
+ */
+double ClusterHierarchy::arcCost(int from, int to) const {
+    for (int a = m_graph.firstArc(from); a < m_graph.firstArc(from + 1); a++) {
+        if (m_graph.arc(a).other == to)
+            return m_graph.arc(a).cost;
+    }
+    return INFINITY;
+}
+
+/**
+ * Adds the transitions of every entrance along one border between two clusters
+ * @param arcs The abstract arcs of each transition, extended with the arcs across the border
+ * @param firstA The first border cell on the side of the first cluster
+ * @param firstB The cell facing it on the side of the second cluster
+ * @param step The id difference between consecutive cells along the border
+ * @param length The number of cells along the border
+ */
+void ClusterHierarchy::addEntrances(vector<vector<AbstractArc>>& arcs, int firstA, int firstB, int step, int length) {
+    int i = 0;
+    while (i < length) {
+        // Find the next run of cells that can be crossed in either direction
+        int begin = i;
+        while (i < length && (arcCost(firstA + i * step, firstB + i * step) != INFINITY
+                              || arcCost(firstB + i * step, firstA + i * step) != INFINITY))
+            i++;
+        int runLength = i - begin;
+        if (runLength == 0) {
+            i++;
+            continue;
+        }
+
+        vector<int> crossings;
+        if (runLength < kWideEntrance)
+            crossings.push_back(begin + runLength / 2);
+        else {
+            for (int crossing = begin; crossing < i - 1; crossing += kTransitionSpacing)
+                crossings.push_back(crossing);
+            crossings.push_back(i - 1);
+        }
+
+        for (int crossing : crossings) {
+            int a = firstA + crossing * step;
+            int b = firstB + crossing * step;
+            int ta = addTransition(a);
+            int tb = addTransition(b);
+            arcs.resize(numTransitions());
+            if (arcCost(a, b) != INFINITY)
+                arcs[ta].push_back({ tb, arcCost(a, b) });
+            if (arcCost(b, a) != INFINITY)
+                arcs[tb].push_back({ ta, arcCost(b, a) });
+        }
+    }
+}
+
+/**
+ * Makes a vertex a transition, unless it already is one
+ * @param v The vertex
+ * @return The index of its transition
+ */
+int ClusterHierarchy::addTransition(int v) {
+    if (m_transitionOf[v] < 0) {
+        m_transitionOf[v] = m_transitions.size();
+        m_transitions.push_back(v);
+        m_clusterTransitions[clusterOf(v)].push_back(m_transitionOf[v]);
+    }
+    return m_transitionOf[v];
+}
+
+/**
+ * Runs Dijkstra's algorithm from a vertex without leaving a block of clusters
+ * @param source The vertex to search from
+ * @param target The vertex to stop at, or -1 to settle the whole block
+ * @param reverse Whether to follow arcs backwards, which gives costs to the source
+ * @param cornerA One corner cluster of the block
+ * @param cornerB The opposite corner cluster of the block; the same as cornerA for a single cluster
+ * @return The cost of the target, INFINITY if it was not reached
+ */
+double ClusterHierarchy::searchClusters(int source, int target, bool reverse, int cornerA, int cornerB) {
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> vertexQueue;
+    int firstRow = min(cornerA / m_clusterCols, cornerB / m_clusterCols) * m_clusterSize;
+    int lastRow = (max(cornerA / m_clusterCols, cornerB / m_clusterCols) + 1) * m_clusterSize;
+    int firstCol = min(cornerA % m_clusterCols, cornerB % m_clusterCols) * m_clusterSize;
+    int lastCol = (max(cornerA % m_clusterCols, cornerB % m_clusterCols) + 1) * m_clusterSize;
+
+    m_gridState.reset();
+    m_gridState.update(source, 0, -1);
+    vertexQueue.push(QueueEntry(0, source));
+
+    while (!vertexQueue.empty()) {
+        int current = vertexQueue.top().second;
+        vertexQueue.pop();
+        if (m_gridState.isSettled(current))
+            continue; // Outdated queue entry
+
+        m_gridState.settle(current);
+        if (current == target)
+            return m_gridState.cost(target);
+
+        int first = reverse ? m_graph.firstReverseArc(current) : m_graph.firstArc(current);
+        int last = reverse ? m_graph.firstReverseArc(current + 1) : m_graph.firstArc(current + 1);
+        for (int a = first; a < last; a++) {
+            const CompactArc& arc = reverse ? m_graph.reverseArc(a) : m_graph.arc(a);
+            int row = arc.other / m_graph.numCols();
+            int col = arc.other % m_graph.numCols();
+            if (row < firstRow || row >= lastRow || col < firstCol || col >= lastCol)
+                continue; // Outside the block
+
+            double cost = m_gridState.cost(current) + arc.cost;
+            if (!m_gridState.isSettled(arc.other) && cost < m_gridState.cost(arc.other)) {
+                m_gridState.update(arc.other, cost, current);
+                vertexQueue.push(QueueEntry(cost, arc.other));
+            }
+        }
+    }
+
+    return target < 0 ? 0 : m_gridState.cost(target);
+}
+
+/**
+ * Runs A* on the abstract graph, from the transitions linked to the start to
+ * the extra vertex that stands for the end
+ * @param startCluster The cluster of the start
+ * @param end The location of the end, for the heuristic
+ * @return The cost of the abstract path, INFINITY if there is none; its
+ *         transitions are left in m_route
+ */
+double ClusterHierarchy::searchAbstract(int startCluster, TBLoc end) {
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> vertexQueue;
+    int endVertex = numTransitions();
+    m_route.clear();
+
+    m_abstractState.reset();
+    for (int u : m_clusterTransitions[startCluster]) {
+        if (m_startLink[u] != INFINITY) {
+            m_abstractState.update(u, m_startLink[u], -1);
+            vertexQueue.push(QueueEntry(m_startLink[u] + m_heuristicFn(m_graph.location(m_transitions[u]), end, m_world), u));
+        }
+    }
+
+    while (!vertexQueue.empty()) {
+        int current = vertexQueue.top().second;
+        vertexQueue.pop();
+        if (m_abstractState.isSettled(current))
+            continue; // Outdated queue entry
+
+        m_abstractState.settle(current);
+        if (current == endVertex) {
+            m_abstractState.extractPath(endVertex, m_route);
+            m_route.pop_back();
+            return m_abstractState.cost(endVertex);
+        }
+
+        double currentCost = m_abstractState.cost(current);
+        if (m_endLink[current] != INFINITY && currentCost + m_endLink[current] < m_abstractState.cost(endVertex)) {
+            m_abstractState.update(endVertex, currentCost + m_endLink[current], current);
+            vertexQueue.push(QueueEntry(currentCost + m_endLink[current], endVertex));
+        }
+        for (int a = m_firstAbstractArc[current]; a < m_firstAbstractArc[current + 1]; a++) {
+            const AbstractArc& arc = m_abstractArcs[a];
+            double cost = currentCost + arc.cost;
+            if (!m_abstractState.isSettled(arc.other) && cost < m_abstractState.cost(arc.other)) {
+                m_abstractState.update(arc.other, cost, current);
+                double estimate = m_heuristicFn(m_graph.location(m_transitions[arc.other]), end, m_world);
+                vertexQueue.push(QueueEntry(cost + estimate, arc.other)); // Priority is potential cost of path including this vertex
+            }
+        }
+    }
+
+    return INFINITY;
+}
+
+/**
+ * Appends the grid steps of one abstract arc, or of a path inside one cluster,
+ * to a path
+ * @param from The vertex the path has reached so far
+ * @param to The vertex to continue to
+ * @param path The path to extend; from is already its last location
+ */
+void ClusterHierarchy::appendSegment(int from, int to, vector<TBLoc>& path) {
+    if (from == to)
+        return;
+    if (clusterOf(from) != clusterOf(to)) {
+        path.push_back(m_graph.location(to)); // A single arc across a border
+        return;
+    }
+
+    searchClusters(from, to, false, clusterOf(from), clusterOf(from));
+    m_gridState.extractPath(to, m_vertices);
+    for (int i = 1; i < (int) m_vertices.size(); i++)
+        path.push_back(m_graph.location(m_vertices[i]));
+}
@@ -0,0 +1,84 @@
+/**
+ * Declares the ClusterHierarchy class, which finds near-optimal paths on big
+ * worlds by searching an abstract graph of clusters (HPA*)
+ * @file ClusterHierarchy.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef CLUSTERHIERARCHY_H
+#define CLUSTERHIERARCHY_H
+
+#include <vector>
+#include "CompactGraph.h"
+#include "SearchState.h"
+#include "grid.h"
+#include "types.h"
+
+/*
+ * Hierarchical path-finding A* (HPA*).  The grid is cut into square clusters.
+ * Where two neighboring clusters touch, every run of passable border cells is
+ * an entrance, represented by one or two pairs of transition cells, one on
+ * each side.  The transition cells form an abstract graph: arcs across the
+ * border come from the grid, and arcs between the transition cells of one
+ * cluster carry the cost of the cheapest path that stays inside the cluster.
+ *
+ * A query links the start and end into the abstract graph with searches
+ * inside their own clusters, runs A* on the abstract graph and then refines
+ * each abstract arc into grid steps with another search inside one cluster.
+ * When the start and end lie in the same or neighboring clusters, a search
+ * inside just those clusters is tried as well and wins if it is cheaper.
+ * Paths are optimal at the level of the abstract graph only, so they may cost
+ * slightly more than the true shortest path.
+ *
+ * Queries reuse internal buffers and must not run concurrently.
+ */
+class ClusterHierarchy {
+public:
+    ClusterHierarchy(const CompactGraph& graph, const Grid<double>& world,
+                     double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                     int clusterSize = 16);
+
+    int clusterSize() const { return m_clusterSize; }
+    int numTransitions() const { return m_transitions.size(); }
+
+    double findPath(TBLoc start, TBLoc end, vector<TBLoc>& path);
+
+private:
+    /*
+     * An arc of the abstract graph, to another transition.
+     */
+    struct AbstractArc {
+        int other;
+        double cost;
+    };
+
+    const CompactGraph& m_graph;
+    const Grid<double>& m_world;
+    double (*m_heuristicFn)(TBLoc from, TBLoc to, const Grid<double>& world);
+    int m_clusterSize;
+    int m_clusterCols;
+
+    vector<int> m_transitions;              // grid vertex of each transition cell
+    vector<int> m_transitionOf;             // transition of each grid vertex, -1 if none
+    vector<vector<int>> m_clusterTransitions;
+    vector<int> m_firstAbstractArc;         // abstract arcs, stored like CompactGraph arcs
+    vector<AbstractArc> m_abstractArcs;
+
+    // query buffers
+    SearchState m_gridState;
+    SearchState m_abstractState;
+    vector<double> m_startLink;             // cost from the start to each transition, if linked
+    vector<double> m_endLink;               // cost from each transition to the end, if linked
+    vector<int> m_route;                    // transitions of the abstract path
+    vector<int> m_vertices;
+
+    int clusterOf(int v) const;
+    double arcCost(int from, int to) const;
+    void addEntrances(vector<vector<AbstractArc>>& arcs, int firstA, int firstB, int step, int length);
+    int addTransition(int v);
+    double searchClusters(int source, int target, bool reverse, int cornerA, int cornerB);
+    double searchAbstract(int startCluster, TBLoc end);
+    void appendSegment(int from, int to, vector<TBLoc>& path);
+};
+
+#endif // CLUSTERHIERARCHY_H
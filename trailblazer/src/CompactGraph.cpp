@@ -0,0 +1,174 @@
+/**
+ * Defines the CompactGraph class
+ * @file CompactGraph.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <fstream>
+#include "CompactGraph.h"
+
+using namespace std;
+
+static const char kFileMagic[4] = { 'T', 'B', 'C', 'G' };
+static const int kFileVersion = 1;
+
+/**
+ * Creates an empty graph, to be filled by load
+ */
+CompactGraph::CompactGraph() : m_numRows(0), m_numCols(0) {
+    m_firstArc.assign(1, 0);
+    m_firstReverseArc.assign(1, 0);
+}
+
+/**
+ * Copies the vertices and arcs of a grid-shaped graph into contiguous arrays
+ * @param graph The graph to copy, typically the cached graph of a world
+ */
+CompactGraph::CompactGraph(const BasicGraph& graph) {
+    int maxRow = -1;
+    int maxCol = -1;
+    for (Vertex* vertex : graph.getVertexSet()) {
+        maxRow = max(maxRow, vertex->m_row);
+        maxCol = max(maxCol, vertex->m_col);
+    }
+    m_numRows = maxRow + 1;
+    m_numCols = maxCol + 1;
+
+    int vertexCount = numVertices();
+    m_firstArc.assign(vertexCount + 1, 0);
+    m_firstReverseArc.assign(vertexCount + 1, 0);
+
+    // Count the arcs leaving & entering each vertex
+    for (Vertex* vertex : graph.getVertexSet()) {
+        for (Edge* edge : vertex->arcs) {
+            m_firstArc[vertexId(edge->start->m_row, edge->start->m_col) + 1]++;
+            m_firstReverseArc[vertexId(edge->finish->m_row, edge->finish->m_col) + 1]++;
+        }
+    }
+    for (int v = 0; v < vertexCount; v++) {
+        m_firstArc[v + 1] += m_firstArc[v];
+        m_firstReverseArc[v + 1] += m_firstReverseArc[v];
+    }
+
+    // Place each arc in its slot
+    m_arcs.resize(m_firstArc[vertexCount]);
+    m_reverseArcs.resize(m_firstReverseArc[vertexCount]);
+    vector<int> nextArc(m_firstArc.begin(), m_firstArc.end() - 1);
+    vector<int> nextReverseArc(m_firstReverseArc.begin(), m_firstReverseArc.end() - 1);
+    for (Vertex* vertex : graph.getVertexSet()) {
+        for (Edge* edge : vertex->arcs) {
+            int from = vertexId(edge->start->m_row, edge->start->m_col);
+            int to = vertexId(edge->finish->m_row, edge->finish->m_col);
+            m_arcs[nextArc[from]++] = { to, (float) edge->cost };
+            m_reverseArcs[nextReverseArc[to]++] = { from, (float) edge->cost };
+        }
+    }
+}
+
+/**
+ * Checks whether a location lies within the grid of the graph
+ * @param loc The location to check
+ * @return True if the location has an id in this graph
+ */
+bool CompactGraph::inBounds(TBLoc loc) const {
+    return loc.row >= 0 && loc.row < m_numRows && loc.col >= 0 && loc.col < m_numCols;
+}
+
+/**
+ * Writes a plain value to a binary stream
+ */
+template <typename T>
+static void writeValue(ostream& output, const T& value) {
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Reads a plain value from a binary stream
+ */
+template <typename T>
+static void readValue(istream& input, T& value) {
+    input.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+/**
+ * Writes the arcs of the graph to a binary file; the reverse arcs are rebuilt on load
+ * @param filename The file to write
+ * @return True if the file was written successfully
+ */
+bool CompactGraph::save(const string& filename) const {
+    ofstream output(filename.c_str(), ios::binary);
+    if (output.fail())
+        return false;
+
+    output.write(kFileMagic, sizeof(kFileMagic));
+    writeValue(output, kFileVersion);
+    writeValue(output, m_numRows);
+    writeValue(output, m_numCols);
+    output.write(reinterpret_cast<const char*>(m_firstArc.data()), m_firstArc.size() * sizeof(int));
+    output.write(reinterpret_cast<const char*>(m_arcs.data()), m_arcs.size() * sizeof(CompactArc));
+    return !output.fail();
+}
+
+/**
+ * Replaces this graph with one read from a file written by save
+ * @param filename The file to read
+ * @return True if the file was read successfully; on failure the graph is left empty
+ */
+bool CompactGraph::load(const string& filename) {
+    *this = CompactGraph();
+    ifstream input(filename.c_str(), ios::binary);
+    if (input.fail())
+        return false;
+
+    char magic[sizeof(kFileMagic)];
+    int version = 0;
+    int numRows = 0;
+    int numCols = 0;
+    input.read(magic, sizeof(magic));
+    readValue(input, version);
+    readValue(input, numRows);
+    readValue(input, numCols);
+    if (input.fail() || !equal(magic, magic + sizeof(magic), kFileMagic)
+            || version != kFileVersion || numRows < 0 || numCols < 0)
+        return false;
+
+    int vertexCount = numRows * numCols;
+    vector<int> firstArc(vertexCount + 1);
+    input.read(reinterpret_cast<char*>(firstArc.data()), firstArc.size() * sizeof(int));
+    if (input.fail() || firstArc[0] != 0 || firstArc[vertexCount] < 0)
+        return false;
+    vector<CompactArc> arcs(firstArc[vertexCount]);
+    input.read(reinterpret_cast<char*>(arcs.data()), arcs.size() * sizeof(CompactArc));
+    if (input.fail())
+        return false;
+    for (int v = 0; v < vertexCount; v++) {
+        if (firstArc[v + 1] < firstArc[v])
+            return false;
+    }
+    for (const CompactArc& arc : arcs) {
+        if (arc.other < 0 || arc.other >= vertexCount)
+            return false;
+    }
+
+    // Rebuild the reverse arcs by counting the arcs entering each vertex
+    vector<int> firstReverseArc(vertexCount + 1, 0);
+    for (const CompactArc& arc : arcs)
+        firstReverseArc[arc.other + 1]++;
+    for (int v = 0; v < vertexCount; v++)
+        firstReverseArc[v + 1] += firstReverseArc[v];
+    vector<CompactArc> reverseArcs(arcs.size());
+    vector<int> nextReverseArc(firstReverseArc.begin(), firstReverseArc.end() - 1);
+    for (int v = 0; v < vertexCount; v++) {
+        for (int a = firstArc[v]; a < firstArc[v + 1]; a++)
+            reverseArcs[nextReverseArc[arcs[a].other]++] = { v, arcs[a].cost };
+    }
+
+    m_numRows = numRows;
+    m_numCols = numCols;
+    m_firstArc.swap(firstArc);
+    m_arcs.swap(arcs);
+    m_firstReverseArc.swap(firstReverseArc);
+    m_reverseArcs.swap(reverseArcs);
+    return true;
+}
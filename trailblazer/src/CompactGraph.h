@@ -0,0 +1,71 @@
+/**
+ * Declares the CompactGraph class, an immutable array-based copy of a world graph
+ * @file CompactGraph.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+#include <string>
+#include <vector>
+#include "BasicGraph.h"
+#include "types.h"
+
+/*
+ * A single outgoing (or, in the reverse arrays, incoming) arc of a CompactGraph.
+ * 'other' is the id of the vertex at the opposite end of the arc.  The cost is
+ * kept in single precision so that an arc takes 8 bytes and eight of them share
+ * a cache line.
+ */
+struct CompactArc {
+    int other;
+    float cost;
+};
+
+/*
+ * A read-only copy of a grid-shaped BasicGraph where every vertex is identified
+ * by the id row * numCols + col and all arcs are stored contiguously per vertex,
+ * both in forward (outgoing) and reverse (incoming) direction.
+ * Searches on a CompactGraph keep their own state and never touch the nodes
+ * of the BasicGraph it was built from.
+ * The arcs can be saved to disk and loaded again for an identical world without
+ * building the BasicGraph at all.
+ */
+class CompactGraph {
+public:
+    CompactGraph();
+    CompactGraph(const BasicGraph& graph);
+
+    int numVertices() const { return m_numRows * m_numCols; }
+    int numRows() const { return m_numRows; }
+    int numCols() const { return m_numCols; }
+    int numArcs() const { return m_arcs.size(); }
+
+    int vertexId(int row, int col) const { return row * m_numCols + col; }
+    int vertexId(TBLoc loc) const { return vertexId(loc.row, loc.col); }
+    TBLoc location(int id) const { return makeLoc(id / m_numCols, id % m_numCols); }
+    bool inBounds(TBLoc loc) const;
+
+    /*
+     * Outgoing arcs of vertex v are arc(firstArc(v)) ... arc(firstArc(v + 1) - 1),
+     * incoming arcs likewise with firstReverseArc/reverseArc.
+     */
+    int firstArc(int v) const { return m_firstArc[v]; }
+    const CompactArc& arc(int a) const { return m_arcs[a]; }
+    int firstReverseArc(int v) const { return m_firstReverseArc[v]; }
+    const CompactArc& reverseArc(int a) const { return m_reverseArcs[a]; }
+
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+
+private:
+    int m_numRows;
+    int m_numCols;
+    vector<int> m_firstArc;
+    vector<CompactArc> m_arcs;
+    vector<int> m_firstReverseArc;
+    vector<CompactArc> m_reverseArcs;
+};
+
+#endif // COMPACTGRAPH_H
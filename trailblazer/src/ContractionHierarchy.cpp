@@ -0,0 +1,643 @@
+/**
+ * Defines the ContractionHierarchy class: preprocessing, serialisation and
+ * bidirectional upward queries
+ * @file ContractionHierarchy.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include "ContractionHierarchy.h"
+
+using namespace std;
+
+/*
+ * Witness searches during preprocessing give up after settling this many
+ * vertices.  A give-up only ever adds an unneeded shortcut, never a wrong one,
+ * so the cheap limit is used to estimate priorities and the generous one when
+ * a vertex is actually contracted.
+ */
+static const int kEstimateSettleLimit = 30;
+static const int kContractSettleLimit = 500;
+
+/*
+ * Identifies the on-disk format written by save.
+ */
+static const char kFileMagic[4] = { 'T', 'B', 'C', 'H' };
+static const int kFileVersion = 2;
+
+/*
+ * The longest cost function name a file may record
+ */
+static const int kMaxCostNameLength = 64;
+
+/*
+ * An arc of the graph while it is being contracted
+ */
+struct BuildArc {
+    int other;
+    double cost;
+    int middle;
+};
+
+typedef pair<double, int> QueueEntry;
+typedef priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> MinQueue;
+
+/**
+ * Adds an arc to a list, or lowers the cost of an existing arc to the same vertex
+ * @param arcs The arc list of one vertex
+ * @param other The vertex at the other end of the arc
+ * @param cost The cost of the arc
+ * @param middle The vertex bypassed by the arc, -1 if none
+ */
+static void addOrImprove(vector<BuildArc>& arcs, int other, double cost, int middle) {
+    for (BuildArc& arc : arcs) {
+        if (arc.other == other) {
+            if (cost < arc.cost) {
+                arc.cost = cost;
+                arc.middle = middle;
+            }
+            return;
+        }
+    }
+    arcs.push_back({ other, cost, middle });
+}
+
+/*
+ * Everything the preprocessing step needs while contracting vertices.
+ * Witness distances use a stamp per vertex so that a search only costs
+ * as much as the vertices it touches.
+ */
+struct Contractor {
+    vector<vector<BuildArc>> outArcs;
+    vector<vector<BuildArc>> inArcs;
+    vector<int> contractedNeighbors;
+    vector<int> level;
+    vector<double> witnessDistance;
+    vector<unsigned int> witnessStamp;
+    vector<unsigned int> targetStamp;
+    unsigned int witnessSearch;
+    vector<QueueEntry> heap;
+
+    /**
+     * Runs a bounded Dijkstra search from an in-neighbor of a vertex to its
+     * out-neighbors, avoiding the vertex itself
+     * @param source The vertex to search from
+     * @param avoid The vertex being contracted
+     * @param limit Stop once the smallest tentative distance exceeds this
+     * @param settleLimit Stop after settling this many vertices
+     */
+    void findWitnesses(int source, int avoid, double limit, int settleLimit) {
+        witnessSearch++;
+        int targetsLeft = 0;
+        for (const BuildArc& arc : outArcs[avoid]) {
+            if (arc.other != source) {
+                targetStamp[arc.other] = witnessSearch;
+                targetsLeft++;
+            }
+        }
+
+        heap.clear();
+        witnessDistance[source] = 0;
+        witnessStamp[source] = witnessSearch;
+        heap.push_back(QueueEntry(0, source));
+
+        int settled = 0;
+        while (!heap.empty() && settled < settleLimit && targetsLeft > 0) {
+            pop_heap(heap.begin(), heap.end(), greater<QueueEntry>());
+            QueueEntry top = heap.back();
+            heap.pop_back();
+            int current = top.second;
+            if (top.first > witnessDistance[current])
+                continue; // Outdated queue entry
+            if (top.first > limit)
+                break;
+            settled++;
+            if (targetStamp[current] == witnessSearch)
+                targetsLeft--;
+
+            for (const BuildArc& arc : outArcs[current]) {
+                if (arc.other == avoid)
+                    continue;
+
+                double distance = top.first + arc.cost;
+                if (witnessStamp[arc.other] != witnessSearch || distance < witnessDistance[arc.other]) {
+                    witnessDistance[arc.other] = distance;
+                    witnessStamp[arc.other] = witnessSearch;
+                    heap.push_back(QueueEntry(distance, arc.other));
+                    push_heap(heap.begin(), heap.end(), greater<QueueEntry>());
+                }
+            }
+        }
+    }
+
+    /**
+     * Determines the shortcuts needed to contract a vertex
+     * @param v The vertex to contract
+     * @param shortcuts Filled with the shortcuts as (from, arc) pairs; may be nullptr to only count them
+     * @return The number of shortcuts needed
+     */
+    int findShortcuts(int v, vector<pair<int, BuildArc>>* shortcuts) {
+        int count = 0;
+        for (const BuildArc& inArc : inArcs[v]) {
+            int from = inArc.other;
+            double maxOutCost = 0;
+            for (const BuildArc& outArc : outArcs[v]) {
+                if (outArc.other != from)
+                    maxOutCost = max(maxOutCost, outArc.cost);
+            }
+            findWitnesses(from, v, inArc.cost + maxOutCost,
+                          shortcuts != nullptr ? kContractSettleLimit : kEstimateSettleLimit);
+
+            for (const BuildArc& outArc : outArcs[v]) {
+                int to = outArc.other;
+                if (to == from)
+                    continue;
+
+                // A shortcut is only needed if no path of equal or lower cost avoids v
+                double viaCost = inArc.cost + outArc.cost;
+                if (witnessStamp[to] != witnessSearch || witnessDistance[to] > viaCost) {
+                    count++;
+                    if (shortcuts != nullptr)
+                        shortcuts->push_back(make_pair(from, BuildArc{ to, viaCost, v }));
+                }
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Unlinks a contracted vertex from its neighbors, so that the arc lists
+     * only ever hold arcs between vertices still to be contracted
+     * @param v The vertex to remove
+     */
+    void removeVertex(int v) {
+        for (const BuildArc& arc : outArcs[v])
+            unlink(inArcs[arc.other], v);
+        for (const BuildArc& arc : inArcs[v])
+            unlink(outArcs[arc.other], v);
+        outArcs[v].clear();
+        inArcs[v].clear();
+    }
+
+    /**
+     * Removes the arc to or from one vertex from an arc list
+     * @param arcs The arc list to remove from
+     * @param other The vertex whose arc to remove
+     */
+    static void unlink(vector<BuildArc>& arcs, int other) {
+        for (size_t i = 0; i < arcs.size(); i++) {
+            if (arcs[i].other == other) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+
+    /**
+     * Estimates how attractive it is to contract a vertex now; lower is better
+     * @param v The vertex to rate
+     * @return A mix of the edge difference, the number of already contracted
+     *         neighbors and the depth in the hierarchy
+     */
+    int priority(int v) {
+        int removed = inArcs[v].size() + outArcs[v].size();
+        return 2 * (findShortcuts(v, nullptr) - removed) + contractedNeighbors[v] + level[v];
+    }
+};
+
+/**
+ * Creates an empty hierarchy, to be filled by load
+ */
+ContractionHierarchy::ContractionHierarchy() {
+    m_numRows = 0;
+    m_numCols = 0;
+    m_query = 0;
+}
+
+/**
+ * Preprocesses a graph into a contraction hierarchy
+ * @param graph The graph to preprocess
+ */
+ContractionHierarchy::ContractionHierarchy(const CompactGraph& graph) {
+    m_numRows = graph.numRows();
+    m_numCols = graph.numCols();
+    m_query = 0;
+    contract(graph);
+    resizeQueryBuffers();
+}
+
+/**
+ * Contracts all vertices of a graph and stores the resulting upward arcs
+ * @param graph The graph to contract
+ */
+void ContractionHierarchy::contract(const CompactGraph& graph) {
+    int vertexCount = graph.numVertices();
+
+    Contractor contractor;
+    contractor.outArcs.resize(vertexCount);
+    contractor.inArcs.resize(vertexCount);
+    contractor.contractedNeighbors.assign(vertexCount, 0);
+    contractor.level.assign(vertexCount, 0);
+    contractor.witnessDistance.assign(vertexCount, 0);
+    contractor.witnessStamp.assign(vertexCount, 0);
+    contractor.targetStamp.assign(vertexCount, 0);
+    contractor.witnessSearch = 0;
+    for (int v = 0; v < vertexCount; v++) {
+        for (int a = graph.firstArc(v); a < graph.firstArc(v + 1); a++) {
+            const CompactArc& arc = graph.arc(a);
+            if (arc.other != v) {
+                addOrImprove(contractor.outArcs[v], arc.other, arc.cost, -1);
+                addOrImprove(contractor.inArcs[arc.other], v, arc.cost, -1);
+            }
+        }
+    }
+
+    // Order vertices by priority, updating priorities lazily as they are popped
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+    for (int v = 0; v < vertexCount; v++)
+        order.push(make_pair(contractor.priority(v), v));
+
+    vector<vector<UpArc>> upArcs(vertexCount);
+    vector<vector<UpArc>> downArcs(vertexCount);
+    m_rank.assign(vertexCount, 0);
+    int nextRank = 0;
+    vector<pair<int, BuildArc>> shortcuts;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+
+        int currentPriority = contractor.priority(v);
+        if (!order.empty() && currentPriority > order.top().first) {
+            order.push(make_pair(currentPriority, v));
+            continue;
+        }
+
+        shortcuts.clear();
+        contractor.findShortcuts(v, &shortcuts);
+        for (const pair<int, BuildArc>& shortcut : shortcuts) {
+            const BuildArc& arc = shortcut.second;
+            addOrImprove(contractor.outArcs[shortcut.first], arc.other, arc.cost, arc.middle);
+            addOrImprove(contractor.inArcs[arc.other], shortcut.first, arc.cost, arc.middle);
+        }
+
+        // Every arc still connecting v to the rest of the graph leads upwards
+        vector<int> neighbors;
+        for (const BuildArc& arc : contractor.outArcs[v]) {
+            upArcs[v].push_back({ arc.other, arc.cost, arc.middle });
+            neighbors.push_back(arc.other);
+        }
+        for (const BuildArc& arc : contractor.inArcs[v]) {
+            downArcs[v].push_back({ arc.other, arc.cost, arc.middle });
+            neighbors.push_back(arc.other);
+        }
+
+        contractor.removeVertex(v);
+        m_rank[v] = nextRank++;
+
+        // Contracting around a vertex makes it less attractive to contract next
+        sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        for (int neighbor : neighbors) {
+            contractor.contractedNeighbors[neighbor]++;
+            contractor.level[neighbor] = max(contractor.level[neighbor], contractor.level[v] + 1);
+        }
+    }
+
+    // Flatten the per-vertex lists into contiguous arrays
+    m_firstUpArc.assign(vertexCount + 1, 0);
+    m_firstDownArc.assign(vertexCount + 1, 0);
+    m_upArcs.clear();
+    m_downArcs.clear();
+    for (int v = 0; v < vertexCount; v++) {
+        m_upArcs.insert(m_upArcs.end(), upArcs[v].begin(), upArcs[v].end());
+        m_downArcs.insert(m_downArcs.end(), downArcs[v].begin(), downArcs[v].end());
+        m_firstUpArc[v + 1] = m_upArcs.size();
+        m_firstDownArc[v + 1] = m_downArcs.size();
+    }
+}
+
+/**
+ * Sizes the per-query buffers to the number of vertices in the hierarchy
+ */
+void ContractionHierarchy::resizeQueryBuffers() {
+    for (int direction = 0; direction < 2; direction++) {
+        m_distance[direction].assign(m_rank.size(), INFINITY);
+        m_parent[direction].assign(m_rank.size(), -1);
+        m_stamp[direction].assign(m_rank.size(), 0);
+    }
+    m_query = 0;
+}
+
+/**
+ * Finds the cheapest hierarchy arc between two vertices
+ * @param from The start vertex of the arc
+ * @param to The end vertex of the arc
+ * @return The arc, or nullptr if there is none
+ */
+const ContractionHierarchy::UpArc* ContractionHierarchy::findArc(int from, int to) const {
+    const UpArc* best = nullptr;
+    if (m_rank[from] < m_rank[to]) {
+        for (int a = m_firstUpArc[from]; a < m_firstUpArc[from + 1]; a++) {
+            if (m_upArcs[a].other == to && (best == nullptr || m_upArcs[a].cost < best->cost))
+                best = &m_upArcs[a];
+        }
+    }
+    else {
+        for (int a = m_firstDownArc[to]; a < m_firstDownArc[to + 1]; a++) {
+            if (m_downArcs[a].other == from && (best == nullptr || m_downArcs[a].cost < best->cost))
+                best = &m_downArcs[a];
+        }
+    }
+    return best;
+}
+
+/**
+ * Expands an arc, recursively replacing shortcuts with the arcs they bypass
+ * @param from The start vertex of the arc
+ * @param to The end vertex of the arc
+ * @param path Receives every vertex after 'from' up to and including 'to'
+ */
+void ContractionHierarchy::unpackArc(int from, int to, vector<int>& path) const {
+    const UpArc* arc = findArc(from, to);
+    if (arc == nullptr || arc->middle < 0) {
+        path.push_back(to);
+    }
+    else {
+        int middle = arc->middle;
+        unpackArc(from, middle, path);
+        unpackArc(middle, to, path);
+    }
+}
+
+/**
+ * Finds a shortest path via a bidirectional search upwards in the hierarchy
+ * @param start The location to find the path from
+ * @param end The location to find the path to
+ * @param path Receives the locations of the path, empty if there is none; its
+ *             capacity is kept, so a buffer reused across queries stops allocating
+ * @return The cost of the path, INFINITY if there is none
+ */
+double ContractionHierarchy::findPath(TBLoc start, TBLoc end, vector<TBLoc>& path) {
+    path.clear();
+    int source = start.row * m_numCols + start.col;
+    int target = end.row * m_numCols + end.col;
+
+    // Advance the query number, wiping the stamps if it wraps around
+    if (++m_query == 0) {
+        resizeQueryBuffers();
+        m_query = 1;
+    }
+
+    MinQueue queues[2];
+    int origins[2] = { source, target };
+    for (int direction = 0; direction < 2; direction++) {
+        int origin = origins[direction];
+        m_distance[direction][origin] = 0;
+        m_parent[direction][origin] = -1;
+        m_stamp[direction][origin] = m_query;
+        queues[direction].push(QueueEntry(0, origin));
+    }
+
+    double best = (source == target) ? 0 : INFINITY;
+    int meeting = (source == target) ? source : -1;
+    while (!queues[0].empty() || !queues[1].empty()) {
+        for (int direction = 0; direction < 2; direction++) {
+            MinQueue& queue = queues[direction];
+            if (queue.empty())
+                continue;
+            if (queue.top().first >= best) {
+                queue = MinQueue(); // Nothing cheaper can be found in this direction
+                continue;
+            }
+
+            QueueEntry top = queue.top();
+            queue.pop();
+            int current = top.second;
+            if (top.first > m_distance[direction][current])
+                continue; // Outdated queue entry
+
+            // Check whether the searches have met here
+            int other = 1 - direction;
+            if (m_stamp[other][current] == m_query && top.first + m_distance[other][current] < best) {
+                best = top.first + m_distance[other][current];
+                meeting = current;
+            }
+
+            // Stall-on-demand: a vertex reached more cheaply through a higher
+            // vertex than it was settled with cannot be on a shortest path
+            const vector<int>& firstArc = (direction == 0) ? m_firstUpArc : m_firstDownArc;
+            const vector<UpArc>& arcs = (direction == 0) ? m_upArcs : m_downArcs;
+            const vector<int>& firstOppositeArc = (direction == 0) ? m_firstDownArc : m_firstUpArc;
+            const vector<UpArc>& oppositeArcs = (direction == 0) ? m_downArcs : m_upArcs;
+            bool stalled = false;
+            for (int a = firstOppositeArc[current]; a < firstOppositeArc[current + 1] && !stalled; a++) {
+                int higher = oppositeArcs[a].other;
+                stalled = m_stamp[direction][higher] == m_query
+                          && m_distance[direction][higher] + oppositeArcs[a].cost < top.first;
+            }
+            if (stalled)
+                continue;
+
+            for (int a = firstArc[current]; a < firstArc[current + 1]; a++) {
+                int next = arcs[a].other;
+                double distance = top.first + arcs[a].cost;
+                if (m_stamp[direction][next] != m_query || distance < m_distance[direction][next]) {
+                    m_distance[direction][next] = distance;
+                    m_parent[direction][next] = current;
+                    m_stamp[direction][next] = m_query;
+                    queue.push(QueueEntry(distance, next));
+                }
+            }
+        }
+    }
+
+    if (meeting < 0)
+        return INFINITY;
+
+    // Collect the upward chain from the source and the downward chain to the target
+    m_chain.clear();
+    for (int v = meeting; v != -1; v = m_parent[0][v])
+        m_chain.push_back(v);
+    reverse(m_chain.begin(), m_chain.end());
+    for (int v = m_parent[1][meeting]; v != -1; v = m_parent[1][v])
+        m_chain.push_back(v);
+
+    m_unpacked.clear();
+    m_unpacked.push_back(m_chain[0]);
+    for (size_t i = 1; i < m_chain.size(); i++)
+        unpackArc(m_chain[i - 1], m_chain[i], m_unpacked);
+
+    path.reserve(m_unpacked.size());
+    for (int v : m_unpacked)
+        path.push_back(makeLoc(v / m_numCols, v % m_numCols));
+    return best;
+}
+
+/**
+ * Writes a plain value to a binary stream
+ */
+template <typename T>
+static void writeValue(ostream& output, const T& value) {
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Reads a plain value from a binary stream
+ */
+template <typename T>
+static void readValue(istream& input, T& value) {
+    input.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+/**
+ * Writes the hierarchy to a binary file
+ * @param filename The file to write
+ * @param worldHash The hash of the world the hierarchy was built for
+ * @param costName The name of the cost function its arcs were computed with
+ * @return True if the file was written successfully
+ */
+bool ContractionHierarchy::save(const string& filename, unsigned long long worldHash,
+                                const string& costName) const {
+    ofstream output(filename.c_str(), ios::binary);
+    if (output.fail())
+        return false;
+
+    output.write(kFileMagic, sizeof(kFileMagic));
+    writeValue(output, kFileVersion);
+    writeValue(output, m_numRows);
+    writeValue(output, m_numCols);
+    writeValue(output, worldHash);
+    writeValue(output, (int) costName.size());
+    output.write(costName.data(), costName.size());
+    for (int rank : m_rank)
+        writeValue(output, rank);
+
+    const vector<int>* firstArcs[2] = { &m_firstUpArc, &m_firstDownArc };
+    const vector<UpArc>* arcLists[2] = { &m_upArcs, &m_downArcs };
+    for (int direction = 0; direction < 2; direction++) {
+        for (int first : *firstArcs[direction])
+            writeValue(output, first);
+        for (const UpArc& arc : *arcLists[direction]) {
+            writeValue(output, arc.other);
+            writeValue(output, arc.cost);
+            writeValue(output, arc.middle);
+        }
+    }
+    return !output.fail();
+}
+
+/**
+ * Returns the number of bytes of a stream after its current position
+ */
+static long long bytesLeft(istream& input, long long fileSize) {
+    return fileSize - (long long) input.tellg();
+}
+
+/**
+ * Replaces this hierarchy with one read from a file written by save.  Every
+ * count, index and rank is checked before it is used, so that a corrupt or
+ * truncated file is refused rather than read out of bounds: the ranks must
+ * order the vertices, every arc must lead to a higher ranked vertex, and a
+ * shortcut must bypass a vertex ranked below both its ends.
+ * @param filename The file to read
+ * @param worldHash The hash of the world the hierarchy is wanted for
+ * @param costName The name of the cost function it is wanted for
+ * @return True if the file was read successfully and was saved for the same
+ *         world and cost function; otherwise the hierarchy is left empty
+ */
+bool ContractionHierarchy::load(const string& filename, unsigned long long worldHash,
+                                const string& costName) {
+    *this = ContractionHierarchy();
+    ifstream input(filename.c_str(), ios::binary);
+    if (input.fail())
+        return false;
+    input.seekg(0, ios::end);
+    long long fileSize = input.tellg();
+    input.seekg(0, ios::beg);
+
+    char magic[sizeof(kFileMagic)];
+    int version = 0;
+    int numRows = 0;
+    int numCols = 0;
+    unsigned long long savedHash = 0;
+    int costNameLength = 0;
+    input.read(magic, sizeof(magic));
+    readValue(input, version);
+    readValue(input, numRows);
+    readValue(input, numCols);
+    readValue(input, savedHash);
+    readValue(input, costNameLength);
+    if (input.fail() || !equal(magic, magic + sizeof(magic), kFileMagic)
+            || version != kFileVersion || numRows < 0 || numCols < 0
+            || costNameLength < 0 || costNameLength > kMaxCostNameLength)
+        return false;
+    string savedCostName(costNameLength, ' ');
+    input.read(&savedCostName[0], costNameLength);
+    if (input.fail() || savedHash != worldHash || savedCostName != costName)
+        return false;
+
+    // The ranks and both arc offset arrays must fit in what is left of the file
+    long long vertexCount = (long long) numRows * numCols;
+    if (vertexCount >= INT_MAX
+            || (3 * vertexCount + 2) * (long long) sizeof(int) > bytesLeft(input, fileSize))
+        return false;
+
+    vector<int> rank(vertexCount);
+    vector<bool> isRanked(vertexCount, false);
+    for (int& value : rank) {
+        readValue(input, value);
+        if (input.fail() || value < 0 || value >= vertexCount || isRanked[value])
+            return false;
+        isRanked[value] = true;
+    }
+
+    vector<int> firstArcs[2];
+    vector<UpArc> arcLists[2];
+    for (int direction = 0; direction < 2; direction++) {
+        firstArcs[direction].resize(vertexCount + 1);
+        for (int& first : firstArcs[direction])
+            readValue(input, first);
+        if (input.fail() || firstArcs[direction][0] != 0)
+            return false;
+        for (int v = 0; v < vertexCount; v++) {
+            if (firstArcs[direction][v + 1] < firstArcs[direction][v])
+                return false;
+        }
+
+        long long arcCount = firstArcs[direction][vertexCount];
+        long long arcSize = sizeof(int) + sizeof(double) + sizeof(int);
+        if (arcCount * arcSize > bytesLeft(input, fileSize))
+            return false;
+        arcLists[direction].resize(arcCount);
+        for (int v = 0; v < vertexCount; v++) {
+            for (int a = firstArcs[direction][v]; a < firstArcs[direction][v + 1]; a++) {
+                UpArc& arc = arcLists[direction][a];
+                readValue(input, arc.other);
+                readValue(input, arc.cost);
+                readValue(input, arc.middle);
+                if (input.fail() || arc.other < 0 || arc.other >= vertexCount
+                        || rank[arc.other] <= rank[v] || !(arc.cost >= 0))
+                    return false;
+                if (arc.middle != -1 && (arc.middle < 0 || arc.middle >= vertexCount
+                                         || rank[arc.middle] >= rank[v]))
+                    return false;
+            }
+        }
+    }
+
+    m_numRows = numRows;
+    m_numCols = numCols;
+    m_rank.swap(rank);
+    m_firstUpArc.swap(firstArcs[0]);
+    m_upArcs.swap(arcLists[0]);
+    m_firstDownArc.swap(firstArcs[1]);
+    m_downArcs.swap(arcLists[1]);
+    resizeQueryBuffers();
+    return true;
+}
@@ -0,0 +1,74 @@
+/**
+ * Declares the ContractionHierarchy class used for fast repeated path queries on one world
+ * @file ContractionHierarchy.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <string>
+#include <vector>
+#include "CompactGraph.h"
+#include "types.h"
+
+/*
+ * A contraction hierarchy over a world graph.  Vertices are contracted one at a
+ * time in order of importance, adding shortcut arcs that preserve all shortest
+ * path costs.  A query then only has to search upwards in the hierarchy from
+ * both ends, which settles a tiny fraction of the vertices a Dijkstra search would.
+ *
+ * The hierarchy does not refer to the graph it was built from, so it can be
+ * saved to disk and loaded again for an identical world.  The file records the
+ * hash of the world and the name of the cost function it was built with, and
+ * load refuses a file saved for any other, as well as one that is corrupt or
+ * cut short.  Queries reuse internal buffers and must therefore not run
+ * concurrently on the same hierarchy.
+ */
+class ContractionHierarchy {
+public:
+    ContractionHierarchy();
+    ContractionHierarchy(const CompactGraph& graph);
+
+    int numRows() const { return m_numRows; }
+    int numCols() const { return m_numCols; }
+
+    double findPath(TBLoc start, TBLoc end, vector<TBLoc>& path);
+
+    bool save(const string& filename, unsigned long long worldHash, const string& costName) const;
+    bool load(const string& filename, unsigned long long worldHash, const string& costName);
+
+private:
+    /*
+     * An arc of the upward search graphs.  'middle' is the contracted vertex a
+     * shortcut bypasses, or -1 for an arc of the original graph.
+     */
+    struct UpArc {
+        int other;
+        double cost;
+        int middle;
+    };
+
+    int m_numRows;
+    int m_numCols;
+    vector<int> m_rank;
+    vector<int> m_firstUpArc;          // arcs v -> w with rank[w] > rank[v], stored at v
+    vector<UpArc> m_upArcs;
+    vector<int> m_firstDownArc;        // arcs w -> v with rank[w] > rank[v], stored at v
+    vector<UpArc> m_downArcs;
+
+    // query buffers, valid where the stamp equals the current query number
+    vector<double> m_distance[2];
+    vector<int> m_parent[2];
+    vector<unsigned int> m_stamp[2];
+    unsigned int m_query;
+    vector<int> m_chain;      // meeting chain of the last query
+    vector<int> m_unpacked;   // its vertices once the shortcuts are unpacked
+
+    void contract(const CompactGraph& graph);
+    void resizeQueryBuffers();
+    const UpArc* findArc(int from, int to) const;
+    void unpackArc(int from, int to, vector<int>& path) const;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
@@ -0,0 +1,163 @@
+/**
+ * Defines the CostPlanes class and the search on an implicit grid that uses it
+ * @file CostPlanes.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include "CostPlanes.h"
+#include "costs.h"
+
+using namespace std;
+
+// Directions in the order gridToGraph visits neighbors: row by row, skipping the cell itself
+const int CostPlanes::kRowOffset[kNumDirections] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+const int CostPlanes::kColOffset[kNumDirections] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+
+/**
+ * Computes the cost of every arc of a world
+ * @param world The world to compute the costs for
+ * @param costFn The cost of moving between two neighboring locations
+ */
+CostPlanes::CostPlanes(const Grid<double>& world,
+                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    m_numRows = world.numRows();
+    m_numCols = world.numCols();
+    for (vector<double>& plane : m_planes)
+        plane.assign(m_numRows * m_numCols, INFINITY);
+
+    if (costFn != terrainCost && costFn != mazeCost) {
+        fillGeneric(world, costFn);
+        return;
+    }
+
+    // Copy the cells into one contiguous array so that rows can be streamed
+    vector<double> heights(m_numRows * m_numCols);
+    for (int row = 0; row < m_numRows; row++) {
+        for (int col = 0; col < m_numCols; col++)
+            heights[row * m_numCols + col] = world.get(row, col);
+    }
+    if (costFn == terrainCost)
+        fillTerrain(heights);
+    else
+        fillMaze(heights);
+}
+
+/**
+ * Fills the planes with the costs terrainCost gives: the length of the step
+ * plus kAltitudePenalty times the change in height
+ * @param heights The cells of the world, row by row
+ */
+void CostPlanes::fillTerrain(const vector<double>& heights) {
+    for (int d = 0; d < kNumDirections; d++) {
+        int dr = kRowOffset[d];
+        int dc = kColOffset[d];
+        double length = sqrt((double) (dr * dr + dc * dc));
+        int firstCol = max(0, -dc);
+        int lastCol = min(m_numCols, m_numCols - dc);
+        for (int row = max(0, -dr); row < min(m_numRows, m_numRows - dr); row++) {
+            const double* from = &heights[row * m_numCols];
+            const double* to = &heights[(row + dr) * m_numCols + dc];
+            double* cost = &m_planes[d][row * m_numCols];
+            for (int col = firstCol; col < lastCol; col++)
+                cost[col] = length + kAltitudePenalty * fabs(to[col] - from[col]);
+        }
+    }
+}
+
+/**
+ * Fills the planes with the costs mazeCost gives: 1 for a straight step between
+ * two floor cells, and INFINITY for anything else
+ * @param heights The cells of the world, row by row
+ */
+void CostPlanes::fillMaze(const vector<double>& heights) {
+    for (int d = 0; d < kNumDirections; d++) {
+        int dr = kRowOffset[d];
+        int dc = kColOffset[d];
+        if (dr != 0 && dc != 0)
+            continue; // Diagonal steps are never allowed, and the plane already says so
+        int firstCol = max(0, -dc);
+        int lastCol = min(m_numCols, m_numCols - dc);
+        for (int row = max(0, -dr); row < min(m_numRows, m_numRows - dr); row++) {
+            const double* from = &heights[row * m_numCols];
+            const double* to = &heights[(row + dr) * m_numCols + dc];
+            double* cost = &m_planes[d][row * m_numCols];
+            for (int col = firstCol; col < lastCol; col++)
+                cost[col] = ((from[col] != kMazeWall) & (to[col] != kMazeWall)) ? 1.0 : INFINITY;
+        }
+    }
+}
+
+/**
+ * Fills the planes by calling a cost function for every arc
+ * @param world The world to compute the costs for
+ * @param costFn The cost of moving between two neighboring locations
+ */
+void CostPlanes::fillGeneric(const Grid<double>& world,
+                             double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    for (int row = 0; row < m_numRows; row++) {
+        for (int col = 0; col < m_numCols; col++) {
+            for (int d = 0; d < kNumDirections; d++) {
+                int nextRow = row + kRowOffset[d];
+                int nextCol = col + kColOffset[d];
+                if (world.inBounds(nextRow, nextCol))
+                    m_planes[d][row * m_numCols + col] = costFn(makeLoc(row, col), makeLoc(nextRow, nextCol), world);
+            }
+        }
+    }
+}
+
+/**
+ * Find the cheapest path from one vertex to another via the a* algorithm on the
+ * implicit grid of a CostPlanes, without any graph; neighbors are found by
+ * offset and arc costs read from the planes
+ * @param planes The arc costs of the world
+ * @param state The state to search with; reset before the search starts
+ * @param start The vertex to find the path from, row * numCols + col
+ * @param end The vertex to find the path to
+ * @param heuristicFn The estimate of the remaining cost, or nullptr to run Dijkstra's algorithm
+ * @param world The world passed to the heuristic
+ * @return The cost of the path, INFINITY if there is none
+ */
+double gridAStar(const CostPlanes& planes, SearchState& state, int start, int end,
+                 double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                 const Grid<double>& world) {
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> vertexQueue;
+    int numCols = planes.numCols();
+    TBLoc endLoc = makeLoc(end / numCols, end % numCols);
+
+    state.reset();
+    state.update(start, 0, -1);
+    vertexQueue.push(QueueEntry(0, start));
+
+    while (!vertexQueue.empty()) {
+        int current = vertexQueue.top().second;
+        vertexQueue.pop();
+        if (state.isSettled(current))
+            continue; // Outdated queue entry
+
+        state.settle(current);
+        if (current == end)
+            return state.cost(end);
+
+        // Visit each neighbor that is not yet settled; off-grid neighbors have infinite cost
+        for (int d = 0; d < CostPlanes::kNumDirections; d++) {
+            double arcCost = planes.cost(current, d);
+            if (arcCost == INFINITY)
+                continue;
+            int next = current + CostPlanes::kRowOffset[d] * numCols + CostPlanes::kColOffset[d];
+            double cost = state.cost(current) + arcCost;
+            if (!state.isSettled(next) && cost < state.cost(next)) {
+                state.update(next, cost, current);
+                double estimate = heuristicFn == nullptr ? 0 : heuristicFn(makeLoc(next / numCols, next % numCols), endLoc, world);
+                vertexQueue.push(QueueEntry(cost + estimate, next)); // Priority is potential cost of path including this vertex
+            }
+        }
+    }
+
+    return INFINITY;
+}
@@ -0,0 +1,55 @@
+/**
+ * Declares the CostPlanes class, which holds the precomputed cost of every arc
+ * of a grid world, and the search that runs on it
+ * @file CostPlanes.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef COSTPLANES_H
+#define COSTPLANES_H
+
+#include <vector>
+#include "SearchState.h"
+#include "grid.h"
+#include "types.h"
+
+/*
+ * The cost of moving from every cell to each of its eight neighbors, stored as
+ * eight planes, one per direction.  Plane d holds the cost of moving from each
+ * cell to the cell at offset (kRowOffset[d], kColOffset[d]), indexed by the
+ * vertex id row * numCols + col, and INFINITY where that neighbor lies outside
+ * the world or cannot be entered.
+ * For the terrain and maze cost functions of costs.h, each plane is filled in
+ * one pass of branch-free loops over whole rows, which the compiler turns into
+ * SIMD code; any other cost function is simply called once per arc.
+ */
+class CostPlanes {
+public:
+    static const int kNumDirections = 8;
+    static const int kRowOffset[kNumDirections];
+    static const int kColOffset[kNumDirections];
+
+    CostPlanes(const Grid<double>& world,
+               double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
+
+    int numRows() const { return m_numRows; }
+    int numCols() const { return m_numCols; }
+    double cost(int v, int direction) const { return m_planes[direction][v]; }
+    double cost(int row, int col, int direction) const { return m_planes[direction][row * m_numCols + col]; }
+
+private:
+    int m_numRows;
+    int m_numCols;
+    vector<double> m_planes[kNumDirections];
+
+    void fillTerrain(const vector<double>& heights);
+    void fillMaze(const vector<double>& heights);
+    void fillGeneric(const Grid<double>& world,
+                     double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
+};
+
+double gridAStar(const CostPlanes& planes, SearchState& state, int start, int end,
+                 double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                 const Grid<double>& world);
+
+#endif // COSTPLANES_H
@@ -0,0 +1,204 @@
+/**
+ * Defines the delta-stepping search
+ * @file DeltaStepping.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "DeltaStepping.h"
+
+using namespace std;
+
+/*
+ * Makes a fixed number of threads wait for each other between phases.
+ */
+class PhaseBarrier {
+public:
+    PhaseBarrier(int numThreads) : m_numThreads(numThreads), m_waiting(0), m_phase(0) {}
+
+    void wait() {
+        unique_lock<mutex> lock(m_mutex);
+        unsigned int phase = m_phase;
+        if (++m_waiting == m_numThreads) {
+            m_waiting = 0;
+            m_phase++;
+            m_phaseDone.notify_all();
+        }
+        else
+            m_phaseDone.wait(lock, [&] { return m_phase != phase; });
+    }
+
+private:
+    mutex m_mutex;
+    condition_variable m_phaseDone;
+    int m_numThreads;
+    int m_waiting;
+    unsigned int m_phase;
+};
+
+/*
+ * The state shared by the threads of one delta-stepping search.  Thread 0 also
+ * plans each phase: it gathers the requests of all threads into the buckets and
+ * picks the vertices the next phase relaxes.
+ */
+struct DeltaSteppingSearch {
+    const CompactGraph& graph;
+    double delta;
+    vector<atomic<double>> distance;
+    vector<vector<int>> buckets;            // vertices by tentative cost; may hold outdated entries
+    vector<vector<int>> requests;           // vertices each thread lowered in the last phase
+    vector<int> frontier;                   // vertices the current phase relaxes
+    vector<int> settled;                    // vertices taken from the current bucket so far
+    vector<unsigned int> frontierStamp;     // phase in which each vertex was last put in the frontier
+    unsigned int phase;
+    int bucket;                             // index of the current bucket
+    bool heavyPhase;
+    bool done;
+    PhaseBarrier barrier;
+
+    DeltaSteppingSearch(const CompactGraph& graph, double delta, int numThreads)
+        : graph(graph), delta(delta), distance(graph.numVertices()), requests(numThreads),
+          frontierStamp(graph.numVertices(), 0), phase(0), bucket(0), heavyPhase(false),
+          done(false), barrier(numThreads) {}
+
+    int bucketOf(double cost) const { return (int) (cost / delta); }
+};
+
+/**
+ * Lowers a tentative cost if the new one is cheaper, safely from any thread
+ * @param cost The tentative cost to lower
+ * @param candidate The new cost
+ * @return True if the cost was lowered
+ */
+static bool lowerCost(atomic<double>& cost, double candidate) {
+    double current = cost.load(memory_order_relaxed);
+    while (candidate < current) {
+        if (cost.compare_exchange_weak(current, candidate, memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Files the requests of the last phase into buckets and picks the frontier of
+ * the next phase; run by thread 0 alone
+ * @param search The shared search state
+ */
+static void planPhase(DeltaSteppingSearch& search) {
+    for (vector<int>& threadRequests : search.requests) {
+        for (int v : threadRequests) {
+            int b = search.bucketOf(search.distance[v].load(memory_order_relaxed));
+            if (b >= (int) search.buckets.size())
+                search.buckets.resize(b + 1);
+            search.buckets[b].push_back(v);
+        }
+        threadRequests.clear();
+    }
+
+    search.phase++;
+    search.frontier.clear();
+    while (search.bucket < (int) search.buckets.size()) {
+        // Take the vertices still in the current bucket, once each
+        vector<int>& current = search.buckets[search.bucket];
+        for (int v : current) {
+            if (search.bucketOf(search.distance[v].load(memory_order_relaxed)) == search.bucket
+                    && search.frontierStamp[v] != search.phase) {
+                search.frontierStamp[v] = search.phase;
+                search.frontier.push_back(v);
+            }
+        }
+        current.clear();
+
+        if (!search.frontier.empty()) {
+            search.heavyPhase = false;
+            search.settled.insert(search.settled.end(), search.frontier.begin(), search.frontier.end());
+            return;
+        }
+        if (!search.settled.empty()) {
+            // The bucket stays empty, so its vertices are final; relax their heavy arcs
+            search.heavyPhase = true;
+            search.frontier.swap(search.settled);
+            search.settled.clear();
+            search.bucket++;
+            return;
+        }
+        search.bucket++;
+    }
+    search.done = true;
+}
+
+/**
+ * The loop run by every thread: relaxes its share of each phase's frontier
+ * @param search The shared search state
+ * @param id The number of the thread, 0 to numThreads - 1
+ * @param numThreads The number of threads taking part
+ */
+static void runThread(DeltaSteppingSearch& search, int id, int numThreads) {
+    while (true) {
+        if (id == 0)
+            planPhase(search);
+        search.barrier.wait();
+        if (search.done)
+            return;
+
+        // Relax light or heavy arcs of an even share of the frontier
+        const CompactGraph& graph = search.graph;
+        vector<int>& requests = search.requests[id];
+        int size = search.frontier.size();
+        int first = (long long) size * id / numThreads;
+        int last = (long long) size * (id + 1) / numThreads;
+        for (int i = first; i < last; i++) {
+            int v = search.frontier[i];
+            double cost = search.distance[v].load(memory_order_relaxed);
+            for (int a = graph.firstArc(v); a < graph.firstArc(v + 1); a++) {
+                const CompactArc& arc = graph.arc(a);
+                if ((arc.cost > search.delta) != search.heavyPhase)
+                    continue;
+                if (lowerCost(search.distance[arc.other], cost + arc.cost))
+                    requests.push_back(arc.other);
+            }
+        }
+        search.barrier.wait();
+    }
+}
+
+/**
+ * Runs the delta-stepping algorithm
+ * @param graph The graph to search on
+ * @param source The vertex to compute the costs from
+ * @param distance Receives the cost for every vertex, INFINITY if unreachable
+ * @param numThreads The number of threads, or 0 for one per hardware thread
+ * @param delta The width of a bucket, or 0 for the mean arc cost
+ */
+void deltaStepping(const CompactGraph& graph, int source, vector<double>& distance, int numThreads, double delta) {
+    if (numThreads <= 0)
+        numThreads = max(1u, thread::hardware_concurrency());
+    if (delta <= 0) {
+        double total = 0;
+        for (int a = 0; a < graph.numArcs(); a++)
+            total += graph.arc(a).cost;
+        delta = graph.numArcs() == 0 ? 1 : total / graph.numArcs();
+    }
+
+    DeltaSteppingSearch search(graph, delta, numThreads);
+    for (atomic<double>& cost : search.distance)
+        cost.store(INFINITY, memory_order_relaxed);
+    search.distance[source].store(0, memory_order_relaxed);
+    search.requests[0].push_back(source);
+
+    vector<thread> helpers;
+    for (int id = 1; id < numThreads; id++)
+        helpers.push_back(thread(runThread, ref(search), id, numThreads));
+    runThread(search, 0, numThreads);
+    for (thread& helper : helpers)
+        helper.join();
+
+    distance.resize(graph.numVertices());
+    for (int v = 0; v < graph.numVertices(); v++)
+        distance[v] = search.distance[v].load(memory_order_relaxed);
+}
@@ -0,0 +1,26 @@
+/**
+ * Declares the delta-stepping search, which computes the cost from one vertex
+ * to every other on several threads at once
+ * @file DeltaStepping.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <vector>
+#include "CompactGraph.h"
+
+/*
+ * Computes the cost of the cheapest path from the source to every vertex with
+ * the delta-stepping algorithm.  Vertices are kept in buckets of width delta by
+ * tentative cost; all vertices of the lowest bucket are relaxed at once, split
+ * over the threads, first along light arcs (cost <= delta, which may refill the
+ * bucket) and then along heavy ones.  Unreachable vertices get INFINITY.
+ * With numThreads 0, one thread per hardware thread is used; with delta 0, the
+ * mean arc cost of the graph is used as the bucket width.
+ */
+void deltaStepping(const CompactGraph& graph, int source, vector<double>& distance,
+                   int numThreads = 0, double delta = 0);
+
+#endif // DELTASTEPPING_H
@@ -0,0 +1,319 @@
+/**
+ * Defines the IncrementalPlanner class: D* Lite search, repair after changes
+ * and path extraction
+ * @file IncrementalPlanner.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "IncrementalPlanner.h"
+
+using namespace std;
+
+/**
+ * Prepares a planner without any plan
+ * @param graph The graph to plan on, typically the cached graph of a world; must outlive the planner
+ * @param world The world of the graph, passed to the heuristic; must outlive the planner
+ * @param heuristicFn The estimate of the cost between two locations; must never overestimate
+ */
+IncrementalPlanner::IncrementalPlanner(const BasicGraph& graph, const Grid<double>& world,
+                                       double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world))
+    : m_world(world), m_heuristicFn(heuristicFn) {
+    m_numRows = world.numRows();
+    m_numCols = world.numCols();
+    m_nodes.assign(m_numRows * m_numCols, nullptr);
+    for (Vertex* vertex : graph.getVertexSet())
+        m_nodes[vertex->m_row * m_numCols + vertex->m_col] = vertex;
+
+    m_isPlanning = false;
+    m_keyModifier = 0;
+    m_cost.resize(m_nodes.size());
+    m_lookahead.resize(m_nodes.size());
+    m_key1.resize(m_nodes.size());
+    m_key2.resize(m_nodes.size());
+    m_isQueued.resize(m_nodes.size());
+    m_stamp.assign(m_nodes.size(), 0);
+    m_plan = 0;
+}
+
+/**
+ * Finds the cheapest path from one location to another, reusing the tree of the
+ * previous query if it had the same end, and colours the vertices it settles
+ * @param start The location to find the path from
+ * @param end The location to find the path to
+ * @param path Receives the locations of the path, empty if there is none
+ * @return The cost of the path, INFINITY if there is none
+ */
+double IncrementalPlanner::findPath(TBLoc start, TBLoc end, vector<TBLoc>& path) {
+    ColorObserver observer;
+    return findPath(start, end, path, observer);
+}
+
+/**
+ * Finds the cheapest path from one location to another, reusing the tree of the
+ * previous query if it had the same end
+ * @param start The location to find the path from
+ * @param end The location to find the path to
+ * @param path Receives the locations of the path, empty if there is none
+ * @param observer Told about each step of the search (see SearchObserver.h)
+ * @return The cost of the path, INFINITY if there is none
+ */
+template <typename Observer>
+double IncrementalPlanner::findPath(TBLoc start, TBLoc end, vector<TBLoc>& path, Observer& observer) {
+    path.clear();
+    if (!m_world.inBounds(start.row, start.col) || !m_world.inBounds(end.row, end.col))
+        return INFINITY;
+
+    if (!m_isPlanning || end != m_end)
+        startPlan(start, end, observer);
+    else if (start != m_start) {
+        // Keys already queued were made for the old start; raising the modifier keeps them lower bounds
+        m_keyModifier += m_heuristicFn(m_start, start, m_world);
+        m_start = start;
+    }
+
+    int startId = start.row * m_numCols + start.col;
+    touch(startId);
+    computeShortestPath(startId, observer);
+    extractPath(startId, path);
+    return path.empty() ? INFINITY : m_lookahead[startId];
+}
+
+/**
+ * Marks the vertices whose arcs may have changed cost, so that the next query
+ * repairs the tree around them
+ * @param cells The cells whose values changed; the arcs to and from them are affected
+ */
+void IncrementalPlanner::cellsChanged(const Vector<TBLoc>& cells) {
+    if (!m_isPlanning)
+        return;
+
+    // Queueing the vertices is not part of a search, so it is not reported
+    NullObserver observer;
+    int endId = m_end.row * m_numCols + m_end.col;
+    for (const TBLoc& cell : cells) {
+        // An arc into or out of the cell starts at the cell or at one of its neighbors
+        for (int row = cell.row - 1; row <= cell.row + 1; row++) {
+            for (int col = cell.col - 1; col <= cell.col + 1; col++) {
+                if (!m_world.inBounds(row, col))
+                    continue;
+                int v = row * m_numCols + col;
+                touch(v);
+                if (v != endId)
+                    m_lookahead[v] = bestLookahead(v);
+                updateVertex(v, observer);
+            }
+        }
+    }
+}
+
+/**
+ * Throws away the current tree and starts one towards a new end
+ * @param start The location paths are searched from
+ * @param end The location paths lead to
+ * @param observer Told that the end is queued
+ */
+template <typename Observer>
+void IncrementalPlanner::startPlan(TBLoc start, TBLoc end, Observer& observer) {
+    // Advance the plan number, wiping the stamps if it wraps around
+    if (++m_plan == 0) {
+        m_stamp.assign(m_stamp.size(), 0);
+        m_plan = 1;
+    }
+    m_queue = priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>>();
+
+    m_isPlanning = true;
+    m_start = start;
+    m_end = end;
+    m_keyModifier = 0;
+
+    int endId = end.row * m_numCols + end.col;
+    touch(endId);
+    m_lookahead[endId] = 0;
+    updateVertex(endId, observer);
+}
+
+/**
+ * Gives a vertex the initial state of this plan if it has not been used in it yet
+ * @param v The vertex
+ */
+void IncrementalPlanner::touch(int v) {
+    if (m_stamp[v] != m_plan) {
+        m_stamp[v] = m_plan;
+        m_cost[v] = INFINITY;
+        m_lookahead[v] = INFINITY;
+        m_isQueued[v] = false;
+    }
+}
+
+/**
+ * Estimates the cost from the current start to a vertex
+ * @param v The vertex
+ * @return The estimate
+ */
+double IncrementalPlanner::heuristic(int v) const {
+    return m_heuristicFn(m_start, makeLoc(v / m_numCols, v % m_numCols), m_world);
+}
+
+/**
+ * Looks up the cost of the arc between two vertices in the graph
+ * @param from The vertex the arc leaves
+ * @param to The vertex the arc enters
+ * @return The cost, INFINITY if there is no such arc
+ */
+double IncrementalPlanner::arcCost(int from, int to) const {
+    Node* target = m_nodes[to];
+    for (Edge* edge : m_nodes[from]->arcs) {
+        if (edge->finish == target)
+            return edge->cost;
+    }
+    return INFINITY;
+}
+
+/**
+ * Computes the cheapest cost to the end through any neighbor of a vertex
+ * @param v The vertex, which must not be the end
+ * @return The lookahead (rhs) value the vertex should have
+ */
+double IncrementalPlanner::bestLookahead(int v) {
+    double best = INFINITY;
+    for (Edge* edge : m_nodes[v]->arcs) {
+        int next = edge->finish->m_row * m_numCols + edge->finish->m_col;
+        touch(next);
+        best = min(best, edge->cost + m_cost[next]);
+    }
+    return best;
+}
+
+/**
+ * Puts an inconsistent vertex in the queue with its current key, or takes a
+ * consistent one out
+ * @param v The vertex, which must have been touched
+ * @param observer Told that the vertex is queued, or that its key changed
+ */
+template <typename Observer>
+void IncrementalPlanner::updateVertex(int v, Observer& observer) {
+    if (m_cost[v] == m_lookahead[v]) {
+        m_isQueued[v] = false; // Its entries are outdated from now on
+        return;
+    }
+
+    double smaller = min(m_cost[v], m_lookahead[v]);
+    m_key1[v] = smaller + heuristic(v) + m_keyModifier;
+    m_key2[v] = smaller;
+    if (m_isQueued[v])
+        observer.decreased(m_nodes[v]);
+    else
+        observer.pushed(m_nodes[v]);
+    m_isQueued[v] = true;
+    m_queue.push({ m_key1[v], m_key2[v], v });
+}
+
+/**
+ * Settles vertices until the cost from the start is known, repairing whatever
+ * the changes since the last query left inconsistent
+ * @param start The vertex paths are searched from
+ * @param observer Told about each step of the search
+ */
+template <typename Observer>
+void IncrementalPlanner::computeShortestPath(int start, Observer& observer) {
+    while (!m_queue.empty()) {
+        QueueEntry top = m_queue.top();
+        int u = top.vertex;
+        if (!m_isQueued[u] || top.key1 != m_key1[u] || top.key2 != m_key2[u]) {
+            m_queue.pop();
+            continue; // Outdated queue entry
+        }
+
+        // Stop once nothing in the queue can lower the lookahead of the start any more
+        double startSmaller = min(m_cost[start], m_lookahead[start]);
+        QueueEntry startKey = { startSmaller + m_keyModifier, startSmaller, start };
+        if (!(startKey > top) && m_lookahead[start] <= m_cost[start])
+            break;
+        m_queue.pop();
+
+        double smaller = min(m_cost[u], m_lookahead[u]);
+        QueueEntry newKey = { smaller + heuristic(u) + m_keyModifier, smaller, u };
+        if (newKey > top) {
+            // The key was made for an earlier start
+            m_key1[u] = newKey.key1;
+            m_key2[u] = newKey.key2;
+            m_queue.push(newKey);
+            continue;
+        }
+
+        m_isQueued[u] = false;
+        Node* node = m_nodes[u];
+        observer.popped(node);
+
+        bool lowered = m_cost[u] > m_lookahead[u];
+        double oldCost = m_cost[u];
+        m_cost[u] = lowered ? m_lookahead[u] : INFINITY;
+        if (!lowered)
+            updateVertex(u, observer); // u itself may have to be raised again
+
+        // Each predecessor is a neighbor with an arc into u
+        int endId = m_end.row * m_numCols + m_end.col;
+        for (int row = node->m_row - 1; row <= node->m_row + 1; row++) {
+            for (int col = node->m_col - 1; col <= node->m_col + 1; col++) {
+                int s = row * m_numCols + col;
+                if (!m_world.inBounds(row, col) || s == u || s == endId)
+                    continue;
+                double cost = arcCost(s, u);
+                if (cost == INFINITY)
+                    continue;
+
+                touch(s);
+                if (lowered)
+                    m_lookahead[s] = min(m_lookahead[s], cost + m_cost[u]);
+                else if (m_lookahead[s] == cost + oldCost)
+                    m_lookahead[s] = bestLookahead(s); // Its best route went through u
+                updateVertex(s, observer);
+            }
+        }
+        observer.settled(node);
+    }
+
+    if (m_lookahead[start] != INFINITY)
+        observer.reached(m_nodes[start]);
+}
+
+/**
+ * Follows the cheapest arcs from the start down the tree to the end
+ * @param start The vertex to start from
+ * @param path Receives the locations of the path, empty if the end cannot be reached
+ */
+void IncrementalPlanner::extractPath(int start, vector<TBLoc>& path) {
+    // The search may stop before settling the start itself, but its lookahead is final
+    if (m_lookahead[start] == INFINITY)
+        return;
+
+    int endId = m_end.row * m_numCols + m_end.col;
+    int current = start;
+    path.push_back(m_start);
+    while (current != endId && path.size() <= m_nodes.size()) {
+        int best = -1;
+        double bestCost = INFINITY;
+        for (Edge* edge : m_nodes[current]->arcs) {
+            int next = edge->finish->m_row * m_numCols + edge->finish->m_col;
+            touch(next);
+            if (edge->cost + m_cost[next] < bestCost) {
+                bestCost = edge->cost + m_cost[next];
+                best = next;
+            }
+        }
+        if (best < 0)
+            break;
+        current = best;
+        path.push_back(makeLoc(current / m_numCols, current % m_numCols));
+    }
+
+    if (current != endId)
+        path.clear();
+}
+
+// The observers findPath is compiled for
+template double IncrementalPlanner::findPath(TBLoc, TBLoc, vector<TBLoc>&, NullObserver&);
+template double IncrementalPlanner::findPath(TBLoc, TBLoc, vector<TBLoc>&, ColorObserver&);
+template double IncrementalPlanner::findPath(TBLoc, TBLoc, vector<TBLoc>&, CountingObserver&);
@@ -0,0 +1,94 @@
+/**
+ * Declares the IncrementalPlanner class, which keeps a shortest-path tree up to
+ * date while the world changes
+ * @file IncrementalPlanner.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef INCREMENTALPLANNER_H
+#define INCREMENTALPLANNER_H
+
+#include <queue>
+#include <vector>
+#include "BasicGraph.h"
+#include "SearchObserver.h"
+#include "grid.h"
+#include "types.h"
+#include "vector.h"
+
+/*
+ * A D* Lite planner on the cached graph of a world.  It searches backwards
+ * from the end, so the costs it settles are costs to the end, and it keeps them
+ * between queries.  When cells of the world change, only the vertices next to
+ * them are marked for repair, and the next query to the same end fixes just
+ * the part of the tree the change reaches.  The start may move between queries.
+ *
+ * The planner reads arc costs straight from the graph, so the graph must be
+ * updated (see updateWorldCells in adapter.h) before cellsChanged is called.
+ * Its state lives in its own arrays, so it does not disturb other searches.
+ *
+ * Like the searches of trailblazer.h, findPath reports its steps to an
+ * observer (see SearchObserver.h); as the search runs from the end, the vertex
+ * it reaches last is the start.  It is compiled for NullObserver,
+ * ColorObserver and CountingObserver, and the overload without an observer
+ * colours the vertices for the GUI.
+ */
+class IncrementalPlanner {
+public:
+    IncrementalPlanner(const BasicGraph& graph, const Grid<double>& world,
+                       double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world));
+
+    double findPath(TBLoc start, TBLoc end, vector<TBLoc>& path);
+    template <typename Observer>
+    double findPath(TBLoc start, TBLoc end, vector<TBLoc>& path, Observer& observer);
+    void cellsChanged(const Vector<TBLoc>& cells);
+
+private:
+    /*
+     * A queue entry: the two-part D* Lite key and the vertex it belongs to.
+     * Entries whose key no longer matches the vertex's are outdated.
+     */
+    struct QueueEntry {
+        double key1;
+        double key2;
+        int vertex;
+        bool operator>(const QueueEntry& other) const {
+            return key1 > other.key1 || (key1 == other.key1 && key2 > other.key2);
+        }
+    };
+
+    const Grid<double>& m_world;
+    double (*m_heuristicFn)(TBLoc from, TBLoc to, const Grid<double>& world);
+    int m_numRows;
+    int m_numCols;
+    vector<Node*> m_nodes;
+
+    bool m_isPlanning;   // whether the tree below belongs to m_end
+    TBLoc m_start;
+    TBLoc m_end;
+    double m_keyModifier;   // km: heuristic distance the start has moved
+
+    // per-vertex state, valid where the stamp equals the current plan number
+    vector<double> m_cost;       // g
+    vector<double> m_lookahead;  // rhs
+    vector<double> m_key1;       // key of the vertex's queue entry
+    vector<double> m_key2;
+    vector<bool> m_isQueued;
+    vector<unsigned int> m_stamp;
+    unsigned int m_plan;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> m_queue;
+
+    template <typename Observer>
+    void startPlan(TBLoc start, TBLoc end, Observer& observer);
+    void touch(int v);
+    double heuristic(int v) const;
+    double arcCost(int from, int to) const;
+    double bestLookahead(int v);
+    template <typename Observer>
+    void updateVertex(int v, Observer& observer);
+    template <typename Observer>
+    void computeShortestPath(int start, Observer& observer);
+    void extractPath(int start, vector<TBLoc>& path);
+};
+
+#endif // INCREMENTALPLANNER_H
@@ -0,0 +1,149 @@
+/**
+ * Defines the Landmarks class: landmark selection, distance precomputation and
+ * triangle-inequality lower bounds
+ * @file Landmarks.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <cmath>
+#include <functional>
+#include <queue>
+#include "Landmarks.h"
+
+using namespace std;
+
+// Bound on the relative error of a distance summed from the single-precision
+// arc costs of a CompactGraph, against the same sum of the double costs that
+// searches on the BasicGraph use; each arc cost is off by at most 2^-24 of itself
+static const double kCostRounding = 1e-7;
+
+/**
+ * Computes the cost of the cheapest path between one vertex and all others
+ * @param graph The graph to search on
+ * @param source The vertex to search from
+ * @param reverse If true, follows arcs backwards, giving the costs to the source instead
+ * @param distance Receives the cost for every vertex, INFINITY if unreachable
+ */
+static void findDistances(const CompactGraph& graph, int source, bool reverse, vector<double>& distance) {
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> vertexQueue;
+    distance.assign(graph.numVertices(), INFINITY);
+    distance[source] = 0;
+    vertexQueue.push(QueueEntry(0, source));
+
+    while (!vertexQueue.empty()) {
+        QueueEntry top = vertexQueue.top();
+        vertexQueue.pop();
+        int current = top.second;
+        if (top.first > distance[current])
+            continue; // Outdated queue entry
+
+        int first = reverse ? graph.firstReverseArc(current) : graph.firstArc(current);
+        int last = reverse ? graph.firstReverseArc(current + 1) : graph.firstArc(current + 1);
+        for (int a = first; a < last; a++) {
+            const CompactArc& arc = reverse ? graph.reverseArc(a) : graph.arc(a);
+            double cost = top.first + arc.cost;
+            if (cost < distance[arc.other]) {
+                distance[arc.other] = cost;
+                vertexQueue.push(QueueEntry(cost, arc.other));
+            }
+        }
+    }
+}
+
+/**
+ * Picks landmarks by repeatedly choosing the vertex farthest away from all
+ * landmarks chosen so far, then stores the costs from and to each of them
+ * @param graph The graph to pick landmarks in
+ * @param count The number of landmarks to pick
+ */
+Landmarks::Landmarks(const CompactGraph& graph, int count) {
+    m_numCols = graph.numCols();
+    int vertexCount = graph.numVertices();
+
+    // Start from any vertex that can be travelled from
+    int start = -1;
+    for (int v = 0; v < vertexCount && start < 0; v++) {
+        if (graph.firstArc(v) < graph.firstArc(v + 1))
+            start = v;
+    }
+    if (start < 0)
+        return;
+
+    vector<double> nearest;
+    findDistances(graph, start, false, nearest);
+
+    vector<vector<double>> fromLandmark;
+    vector<vector<double>> toLandmark;
+    for (int i = 0; i < count; i++) {
+        // The next landmark is the reachable vertex farthest from the others
+        int farthest = -1;
+        for (int v = 0; v < vertexCount; v++) {
+            if (nearest[v] != INFINITY && nearest[v] > 0 && (farthest < 0 || nearest[v] > nearest[farthest]))
+                farthest = v;
+        }
+        if (farthest < 0)
+            break;
+
+        m_landmarks.push_back(farthest);
+        fromLandmark.push_back(vector<double>());
+        toLandmark.push_back(vector<double>());
+        findDistances(graph, farthest, false, fromLandmark.back());
+        findDistances(graph, farthest, true, toLandmark.back());
+
+        for (int v = 0; v < vertexCount; v++)
+            nearest[v] = min(nearest[v], fromLandmark.back()[v]);
+    }
+
+    // Interleave the distances so that one bound reads two short runs of memory
+    int chosen = m_landmarks.size();
+    m_fromLandmark.resize(vertexCount * chosen);
+    m_toLandmark.resize(vertexCount * chosen);
+    for (int v = 0; v < vertexCount; v++) {
+        for (int i = 0; i < chosen; i++) {
+            m_fromLandmark[v * chosen + i] = fromLandmark[i][v];
+            m_toLandmark[v * chosen + i] = toLandmark[i][v];
+        }
+    }
+}
+
+/**
+ * Gives a lower bound on the cost of travelling between two vertices
+ * @param from The id of the vertex to travel from
+ * @param to The id of the vertex to travel to
+ * @return The largest bound given by any landmark; INFINITY if 'to' cannot be reached
+ */
+double Landmarks::lowerBound(int from, int to) const {
+    int count = m_landmarks.size();
+    if (count == 0)
+        return 0;
+
+    const double* fromLandmarkToV = &m_fromLandmark[from * count];
+    const double* fromLandmarkToT = &m_fromLandmark[to * count];
+    const double* fromVToLandmark = &m_toLandmark[from * count];
+    const double* fromTToLandmark = &m_toLandmark[to * count];
+
+    // Each distance is moved by its largest rounding error in the direction that
+    // lowers the bound, so that the bound stays below the double-precision cost.
+    // Differences of two infinities are NaN and never pass the comparisons
+    double bound = 0;
+    for (int i = 0; i < count; i++) {
+        double forward = fromLandmarkToT[i] * (1 - kCostRounding) - fromLandmarkToV[i] * (1 + kCostRounding);
+        double backward = fromVToLandmark[i] * (1 - kCostRounding) - fromTToLandmark[i] * (1 + kCostRounding);
+        if (forward > bound)
+            bound = forward;
+        if (backward > bound)
+            bound = backward;
+    }
+    return bound;
+}
+
+/**
+ * Gives a lower bound on the cost of travelling between two locations
+ * @param from The location to travel from
+ * @param to The location to travel to
+ * @return The largest bound given by any landmark; INFINITY if 'to' cannot be reached
+ */
+double Landmarks::lowerBound(TBLoc from, TBLoc to) const {
+    return lowerBound(from.row * m_numCols + from.col, to.row * m_numCols + to.col);
+}
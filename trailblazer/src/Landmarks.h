@@ -0,0 +1,40 @@
+/**
+ * Declares the Landmarks class, which gives ALT lower bounds for A* search
+ * @file Landmarks.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <vector>
+#include "CompactGraph.h"
+
+/*
+ * A set of landmark vertices together with the cost of travelling from every
+ * landmark to every vertex and from every vertex to every landmark.
+ * By the triangle inequality, d(v, t) >= d(L, t) - d(L, v) and
+ * d(v, t) >= d(v, L) - d(t, L) for every landmark L, which gives an admissible
+ * and consistent A* heuristic that follows the actual terrain costs.
+ * The distances are summed from the single-precision arc costs of the graph,
+ * so each bound is lowered by their largest rounding error, which keeps it
+ * admissible for the double-precision costs of the BasicGraph too.
+ */
+class Landmarks {
+public:
+    Landmarks(const CompactGraph& graph, int count);
+
+    int numLandmarks() const { return m_landmarks.size(); }
+    TBLoc landmark(int i) const { return makeLoc(m_landmarks[i] / m_numCols, m_landmarks[i] % m_numCols); }
+
+    double lowerBound(int from, int to) const;
+    double lowerBound(TBLoc from, TBLoc to) const;
+
+private:
+    int m_numCols;
+    vector<int> m_landmarks;
+    vector<double> m_fromLandmark;   // d(landmark i, v) at [v * count + i]
+    vector<double> m_toLandmark;     // d(v, landmark i) at [v * count + i]
+};
+
+#endif // LANDMARKS_H
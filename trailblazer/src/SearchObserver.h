@@ -0,0 +1,81 @@
+/**
+ * Declares the observers that the searches of trailblazer.cpp report their
+ * progress to: one that does nothing, one that colours the cells of the GUI and
+ * one that counts events
+ * @file SearchObserver.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef SEARCHOBSERVER_H
+#define SEARCHOBSERVER_H
+
+#include "BasicGraph.h"
+
+/*
+ * The searches are templates on their observer, which is told about each event
+ * of the search through these member functions:
+ *   pushed(v)     v entered the queue (or stack) for the first time
+ *   decreased(v)  v got a cheaper cost while in the queue (a decrease-key)
+ *   popped(v)     v was taken out of the queue
+ *   settled(v)    v is done: all of its neighbors have been looked at
+ *   abandoned(v)  v is done but led nowhere new (a dead end of depth-first search)
+ *   reached(v)    v is the end, and the search stops
+ * The calls are resolved at compile time, so the empty functions of
+ * NullObserver are inlined away and an uninstrumented search does no work
+ * beyond the search itself.
+ */
+
+/*
+ * Ignores every event.
+ */
+class NullObserver {
+public:
+    void pushed(Vertex*) {}
+    void decreased(Vertex*) {}
+    void popped(Vertex*) {}
+    void settled(Vertex*) {}
+    void abandoned(Vertex*) {}
+    void reached(Vertex*) {}
+};
+
+/*
+ * Colours the vertices as the GUI expects: yellow while in the queue, green
+ * once settled or reached, gray for dead ends.  Each colour is drawn, and the
+ * animation delay waited for, by colorCell.
+ */
+class ColorObserver {
+public:
+    void pushed(Vertex* v) { v->setColor(YELLOW); }
+    void decreased(Vertex* v) { v->setColor(YELLOW); }
+    void popped(Vertex*) {}
+    void settled(Vertex* v) { v->setColor(GREEN); }
+    void abandoned(Vertex* v) { v->setColor(GRAY); }
+    void reached(Vertex* v) { v->setColor(GREEN); }
+};
+
+/*
+ * The number of times each event happened during a search.
+ */
+struct SearchCounters {
+    long long pushes = 0;
+    long long pops = 0;
+    long long decreaseKeys = 0;
+    long long settled = 0;   // including dead ends
+};
+
+/*
+ * Counts the events of a search, without colouring anything.
+ */
+class CountingObserver {
+public:
+    SearchCounters counters;
+
+    void pushed(Vertex*) { counters.pushes++; }
+    void decreased(Vertex*) { counters.decreaseKeys++; }
+    void popped(Vertex*) { counters.pops++; }
+    void settled(Vertex*) { counters.settled++; }
+    void abandoned(Vertex*) { counters.settled++; }
+    void reached(Vertex*) {}
+};
+
+#endif // SEARCHOBSERVER_H
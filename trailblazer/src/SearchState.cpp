@@ -0,0 +1,161 @@
+/**
+ * Defines the SearchState class and the searches on a CompactGraph that use it
+ * @file SearchState.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include "SearchState.h"
+
+using namespace std;
+
+/**
+ * Creates a state where every vertex is unreached
+ * @param numVertices The number of vertices of the graph to search
+ */
+SearchState::SearchState(int numVertices) {
+    resize(numVertices);
+}
+
+/**
+ * Adapts the state to a graph with a different number of vertices, wiping it
+ * @param numVertices The number of vertices of the graph to search
+ */
+void SearchState::resize(int numVertices) {
+    m_cost.assign(numVertices, INFINITY);
+    m_previous.assign(numVertices, -1);
+    m_stamp.assign(numVertices, 0);
+    m_currentGeneration = 1;
+}
+
+/**
+ * Makes every vertex unreached again in constant time, by starting a new generation
+ */
+void SearchState::reset() {
+    m_currentGeneration++;
+    if (m_currentGeneration == 1u << 31) {
+        // The counter ran out of bits, so old stamps could look current again
+        m_stamp.assign(m_stamp.size(), 0);
+        m_currentGeneration = 1;
+    }
+}
+
+/**
+ * Records a cheaper way of reaching a vertex
+ * @param v The vertex reached
+ * @param cost The cost of reaching it
+ * @param previous The vertex it was reached from, -1 for the start
+ */
+void SearchState::update(int v, double cost, int previous) {
+    if (!isReached(v))
+        m_stamp[v] = m_currentGeneration << 1;
+    m_cost[v] = cost;
+    m_previous[v] = previous;
+}
+
+/**
+ * Follows the previous vertices back from a vertex
+ * @param end The vertex the path leads to
+ * @param path Receives the vertices from the start to end, empty if end was not reached
+ */
+void SearchState::extractPath(int end, vector<int>& path) const {
+    path.clear();
+    if (!isReached(end))
+        return;
+
+    for (int v = end; v != -1; v = m_previous[v])
+        path.push_back(v);
+    reverse(path.begin(), path.end());
+}
+
+/**
+ * Find the cheapest path from one vertex to another via the a* algorithm,
+ * without touching anything but the given state
+ * @param graph The graph to search on
+ * @param state The state to search with; reset before the search starts
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to
+ * @param heuristicFn The estimate of the remaining cost, or nullptr to run Dijkstra's algorithm
+ * @param world The world passed to the heuristic
+ * @return The cost of the path, INFINITY if there is none
+ */
+double compactAStar(const CompactGraph& graph, SearchState& state, int start, int end,
+                    double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                    const Grid<double>& world) {
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> vertexQueue;
+    TBLoc endLoc = graph.location(end);
+
+    state.reset();
+    state.update(start, 0, -1);
+    vertexQueue.push(QueueEntry(0, start));
+
+    while (!vertexQueue.empty()) {
+        int current = vertexQueue.top().second;
+        vertexQueue.pop();
+        if (state.isSettled(current))
+            continue; // Outdated queue entry
+
+        state.settle(current);
+        if (current == end)
+            return state.cost(end);
+
+        // Visit each neighbor that is not yet settled
+        for (int a = graph.firstArc(current); a < graph.firstArc(current + 1); a++) {
+            const CompactArc& arc = graph.arc(a);
+            double cost = state.cost(current) + arc.cost;
+            if (!state.isSettled(arc.other) && cost < state.cost(arc.other)) {
+                state.update(arc.other, cost, current);
+                double estimate = heuristicFn == nullptr ? 0 : heuristicFn(graph.location(arc.other), endLoc, world);
+                vertexQueue.push(QueueEntry(cost + estimate, arc.other)); // Priority is potential cost of path including this vertex
+            }
+        }
+    }
+
+    return INFINITY;
+}
+
+/**
+ * Find the cheapest path from one vertex to each of a set of targets via
+ * Dijkstra's algorithm, stopping as soon as every target is settled rather than
+ * exploring the whole graph; afterwards state.cost(t) is the cost to target t
+ * @param graph The graph to search on
+ * @param state The state to search with; reset before the search starts
+ * @param start The vertex to find the paths from
+ * @param isTarget Whether each vertex of the graph is a target
+ * @param numTargets The number of vertices for which isTarget is true
+ */
+void compactDijkstra(const CompactGraph& graph, SearchState& state, int start,
+                     const vector<bool>& isTarget, int numTargets) {
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> vertexQueue;
+
+    state.reset();
+    state.update(start, 0, -1);
+    vertexQueue.push(QueueEntry(0, start));
+
+    int targetsLeft = numTargets;
+    while (!vertexQueue.empty() && targetsLeft > 0) {
+        int current = vertexQueue.top().second;
+        vertexQueue.pop();
+        if (state.isSettled(current))
+            continue; // Outdated queue entry
+
+        state.settle(current);
+        if (isTarget[current])
+            targetsLeft--;
+
+        // Visit each neighbor that is not yet settled
+        for (int a = graph.firstArc(current); a < graph.firstArc(current + 1); a++) {
+            const CompactArc& arc = graph.arc(a);
+            double cost = state.cost(current) + arc.cost;
+            if (!state.isSettled(arc.other) && cost < state.cost(arc.other)) {
+                state.update(arc.other, cost, current);
+                vertexQueue.push(QueueEntry(cost, arc.other));
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * Declares the SearchState class, which holds the per-vertex data of a search on a
+ * CompactGraph, and the searches that use it
+ * @file SearchState.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef SEARCHSTATE_H
+#define SEARCHSTATE_H
+
+#include <cmath>
+#include <vector>
+#include "CompactGraph.h"
+#include "grid.h"
+#include "types.h"
+
+/*
+ * The cost, previous vertex and settled flag of every vertex for one search at a
+ * time, kept apart from the graph so that several searches can run on the same
+ * graph at once, each with a state of its own.
+ * Each vertex is stamped with the search that last touched it, and reset only
+ * moves on to a new stamp, so vertices with an older stamp read as unreached
+ * and short searches on big graphs stay cheap.
+ * The state is laid out as parallel arrays of 4-byte entries: costs are kept in
+ * single precision (about seven significant digits, plenty for path costs), and
+ * the settled flag is the lowest bit of the stamp, so that checking whether a
+ * vertex is reached or settled reads a single entry.
+ */
+class SearchState {
+public:
+    SearchState(int numVertices = 0);
+
+    void resize(int numVertices);
+    void reset();
+
+    bool isReached(int v) const { return (m_stamp[v] >> 1) == m_currentGeneration; }
+    double cost(int v) const { return isReached(v) ? m_cost[v] : INFINITY; }
+    int previous(int v) const { return isReached(v) ? m_previous[v] : -1; }
+    bool isSettled(int v) const { return m_stamp[v] == (m_currentGeneration << 1 | 1); }
+
+    void update(int v, double cost, int previous);
+    void settle(int v) { m_stamp[v] |= 1; }
+
+    void extractPath(int end, vector<int>& path) const;
+
+private:
+    vector<float> m_cost;
+    vector<int> m_previous;
+    vector<unsigned int> m_stamp;   // search that last touched each vertex, shifted left once, | settled
+    unsigned int m_currentGeneration;
+};
+
+double compactAStar(const CompactGraph& graph, SearchState& state, int start, int end,
+                    double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                    const Grid<double>& world);
+void compactDijkstra(const CompactGraph& graph, SearchState& state, int start,
+                     const vector<bool>& isTarget, int numTargets);
+
+#endif // SEARCHSTATE_H
@@ -13,25 +13,108 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include "graph.h"
 #include "map.h"
 #include "random.h"
 #include "BasicGraph.h"
+#include "BatchPathFinder.h"
+#include "ClusterHierarchy.h"
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include "CostPlanes.h"
+#include "DeltaStepping.h"
+#include "IncrementalPlanner.h"
+#include "Landmarks.h"
 #include "costs.h"
 #include "trailblazer.h"
 #include "trailblazergui.h"
 #include "types.h"
 #include "adapter.h"
 
+// the most worlds the cache keeps at once; the least recently used one is dropped first
+static const int kMaxCachedWorlds = 4;
+
+/*
+ * Identifies a cached world by content: a hash of its size and cells, and the
+ * cost function its arcs were computed with.
+ */
+struct WorldKey {
+    unsigned long long hash;
+    double (*costFn)(TBLoc from, TBLoc to, const Grid<double>& world);
+
+    bool operator<(const WorldKey& other) const {
+        if (hash != other.hash) {
+            return hash < other.hash;
+        }
+        return less<double (*)(TBLoc, TBLoc, const Grid<double>&)>()(costFn, other.costFn);
+    }
+
+    bool operator==(const WorldKey& other) const {
+        return hash == other.hash && costFn == other.costFn;
+    }
+};
+
+/*
+ * Everything the cache holds for one world.  The structures are built on first
+ * use from a private copy of the world, so they stay valid whatever happens to
+ * the grid they were requested with.
+ */
+struct WorldCacheEntry {
+    WorldKey key;
+    Grid<double> world;
+    unsigned long long lastUse;
+    BasicGraph* graph;
+    CompactGraph* compact;
+    ContractionHierarchy* hierarchy;
+    Landmarks* landmarks;
+    IncrementalPlanner* planner;
+    ClusterHierarchy* clusters;
+};
+
 // global variables
-static Map<Grid<double>*, BasicGraph*> WORLD_CACHE;
+static Map<WorldKey, WorldCacheEntry*> WORLD_CACHE;
+static Map<Grid<double>*, WorldKey> LAST_KEYS;   // key each grid was last found under; all in WORLD_CACHE
+static unsigned long long cacheClock = 0;
+static string cacheDirectory;
 static double (*heuristicFunction)(TBLoc from, TBLoc to, const Grid<double>& world) = NULL;
+static Landmarks* activeLandmarks = NULL;
+static SearchInstrumentation searchInstrumentation = COLOR_CELLS;
+static SearchCounters searchCounters;
 
 
 // function prototype declarations
 static double heuristicAdapter(Node* const from, Node* const to, const Grid<double>& world);
+static double landmarkHeuristicAdapter(Node* const from, Node* const to, const Grid<double>& world);
+static unsigned long long hashWorld(const Grid<double>& world);
+static WorldCacheEntry* findCacheEntry(const Grid<double>& world,
+                                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
+static WorldCacheEntry* knownCacheEntry(const Grid<double>& world,
+                                        double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
+static void forgetGrids(const WorldKey& key);
+static bool sameCells(const Grid<double>& world, const Grid<double>& other);
+static string costFunctionName(double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
+static string cacheFileName(const WorldKey& key, const string& extension);
+static BasicGraph* entryGraph(WorldCacheEntry* entry);
+static CompactGraph* entryCompactGraph(WorldCacheEntry* entry);
+static ContractionHierarchy* entryHierarchy(WorldCacheEntry* entry, const string& filename);
+static Landmarks* entryLandmarks(WorldCacheEntry* entry, int count);
+static IncrementalPlanner* entryPlanner(WorldCacheEntry* entry,
+                                        double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world));
+static ClusterHierarchy* entryClusters(WorldCacheEntry* entry,
+                                       double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world));
+static void deleteCacheEntry(WorldCacheEntry* entry);
+static void flushDerivedCaches(WorldCacheEntry* entry);
+static void updateArc(BasicGraph* graph, const Grid<double>& world,
+                      double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                      TBLoc from, TBLoc to);
+template <typename Observer>
+static void runSearch(AlgorithmType algorithm, BasicGraph& graph, Vertex* start, Vertex* end,
+                      Observer& observer);
 
 
 // function implementations
@@ -47,6 +130,7 @@ BasicGraph* gridToGraph(const Grid<double>& world,
     for (int temp = max(rows, cols); temp > 0; temp /= 10) {
         rowColDigits++;
     }
+    vector<Vertex*> vertices(rows * cols);
     for (int r = 0; r < rows; r++) {
         for (int c = 0; c < cols; c++) {
             string name = vertexName(r, c, world);
@@ -54,33 +138,29 @@ BasicGraph* gridToGraph(const Grid<double>& world,
             v->m_gridValue = world.get(r, c);
             // cout << "  ensureWorldCache adding vertex " << name << endl;
             graph->addVertex(v);
+            vertices[r * cols + c] = v;
         }
     }
 
-    // add edges
+    // add edges, with all costs computed up front in one pass over the grid
+    CostPlanes planes(world, costFn);
     for (int r = 0; r < rows; r++) {
         for (int c = 0; c < cols; c++) {
-            Vertex* v = graph->getVertex(vertexName(r, c, world));
-            for (int dr = -1; dr <= 1; dr++) {
-                for (int dc = -1; dc <= 1; dc++) {
-                    int nr = r + dr;
-                    int nc = c + dc;
-                    if ((dr == 0 && dc == 0) || !world.inBounds(nr, nc)) {
-                        continue;
-                    }
-                    Vertex* neighbor = graph->getVertex(vertexName(nr, nc, world));
-                    double cost = costFn(makeLoc(r, c), makeLoc(nr, nc), world);
-                    if (cost != POSITIVE_INFINITY) {
-                        Edge* e = new Edge(v, neighbor, cost);
-                        e->m_startRow = r;
-                        e->m_startCol = c;
-                        e->m_finishRow = nr;
-                        e->m_finishCol = nc;
-                        graph->addEdge(e);
-                        // cout << "  ensureWorldCache adding edge from "
-                        //      << v->name << " to " << neighbor->name
-                        //      << " (cost " << setprecision(4) << cost << ")" << endl;
-                    }
+            Vertex* v = vertices[r * cols + c];
+            for (int d = 0; d < CostPlanes::kNumDirections; d++) {
+                double cost = planes.cost(r, c, d);
+                if (cost != POSITIVE_INFINITY) {
+                    int nr = r + CostPlanes::kRowOffset[d];
+                    int nc = c + CostPlanes::kColOffset[d];
+                    Edge* e = new Edge(v, vertices[nr * cols + nc], cost);
+                    e->m_startRow = r;
+                    e->m_startCol = c;
+                    e->m_finishRow = nr;
+                    e->m_finishCol = nc;
+                    graph->addEdge(e);
+                    // cout << "  ensureWorldCache adding edge from "
+                    //      << v->name << " to " << vertices[nr * cols + nc]->name
+                    //      << " (cost " << setprecision(4) << cost << ")" << endl;
                 }
             }
         }
@@ -116,21 +196,97 @@ Grid<double>* graphToGrid(BasicGraph* graph) {
 
 void ensureWorldCache(const Grid<double>& world,
                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    entryGraph(knownCacheEntry(world, costFn));
+}
+
+const CompactGraph* ensureCompactGraph(const Grid<double>& world,
+                                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    return entryCompactGraph(knownCacheEntry(world, costFn));
+}
+
+ContractionHierarchy* ensureContractionHierarchy(const Grid<double>& world,
+                                                 double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                                 const string& filename) {
+    return entryHierarchy(knownCacheEntry(world, costFn), filename);
+}
+
+Landmarks* ensureLandmarks(const Grid<double>& world,
+                           double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                           int count) {
+    return entryLandmarks(knownCacheEntry(world, costFn), count);
+}
+
+IncrementalPlanner* ensureIncrementalPlanner(const Grid<double>& world,
+                                             double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                             double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    return entryPlanner(knownCacheEntry(world, costFn), heuristicFn);
+}
+
+ClusterHierarchy* ensureClusterHierarchy(const Grid<double>& world,
+                                         double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                         double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    return entryClusters(knownCacheEntry(world, costFn), heuristicFn);
+}
+
+void updateWorldCells(const Grid<double>& world,
+                      double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                      const Vector<TBLoc>& cells) {
+    // the grid already holds the new values, so find its entry by the key it last had
     Grid<double>* const pWorld = const_cast<Grid<double>*>(&world);
-    if (!WORLD_CACHE.containsKey(pWorld)) {
-        cout << "Preparing world model ..." << endl;
-        BasicGraph* graph = gridToGraph(world, costFn);
-        cout << "World model completed." << endl;
-        WORLD_CACHE[pWorld] = graph;
+    if (!LAST_KEYS.containsKey(pWorld) || !WORLD_CACHE.containsKey(LAST_KEYS[pWorld])
+            || LAST_KEYS[pWorld].costFn != costFn) {
+        return;   // nothing cached yet; the next query builds from the new values
+    }
+    WorldCacheEntry* entry = WORLD_CACHE[LAST_KEYS[pWorld]];
+    WORLD_CACHE.remove(entry->key);
+    forgetGrids(entry->key);   // other grids with the old contents are hashed again when next used
+    foreach (TBLoc cell in cells) {
+        entry->world.set(cell.row, cell.col, world.get(cell.row, cell.col));
+    }
+
+    // costs depend only on the two cells an arc joins, so other arcs are unaffected
+    if (entry->graph != NULL) {
+        BasicGraph* graph = entry->graph;
+        foreach (TBLoc cell in cells) {
+            graph->getVertex(vertexName(cell.row, cell.col, world))->m_gridValue = world.get(cell.row, cell.col);
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    TBLoc neighbor = makeLoc(cell.row + dr, cell.col + dc);
+                    if ((dr == 0 && dc == 0) || !world.inBounds(neighbor.row, neighbor.col)) {
+                        continue;
+                    }
+                    updateArc(graph, entry->world, costFn, cell, neighbor);
+                    updateArc(graph, entry->world, costFn, neighbor, cell);
+                }
+            }
+        }
     }
+
+    flushDerivedCaches(entry);
+    if (entry->planner != NULL) {
+        entry->planner->cellsChanged(cells);
+    }
+
+    // file the entry under its new contents, replacing any entry already there
+    entry->key.hash = hashWorld(entry->world);
+    if (WORLD_CACHE.containsKey(entry->key)) {
+        deleteCacheEntry(WORLD_CACHE[entry->key]);
+    }
+    WORLD_CACHE[entry->key] = entry;
+    LAST_KEYS[pWorld] = entry->key;
+}
+
+void setWorldCacheDirectory(const string& directory) {
+    cacheDirectory = directory;
 }
 
 void flushWorldCache() {
-    foreach (Grid<double>* grid in WORLD_CACHE) {
-        BasicGraph* graph = WORLD_CACHE[grid];
-        delete graph;
+    foreach (WorldKey key in WORLD_CACHE) {
+        deleteCacheEntry(WORLD_CACHE[key]);
     }
     WORLD_CACHE.clear();
+    LAST_KEYS.clear();
+    activeLandmarks = NULL;
 }
 
 Vector<TBLoc>
@@ -140,12 +296,31 @@ shortestPath(TBLoc start,
              double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
              double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
              AlgorithmType algorithm) {
+    static vector<TBLoc> pathBuffer;
+    shortestPath(start, end, world, costFn, heuristicFn, algorithm, pathBuffer);
+
+    // convert vector<Loc> to Vector<Loc>
+    Vector<TBLoc> locResult(pathBuffer.size());
+    for (size_t i = 0; i < pathBuffer.size(); i++) {
+        locResult[i] = pathBuffer[i];
+    }
+    return locResult;
+}
+
+void
+shortestPath(TBLoc start,
+             TBLoc end,
+             const Grid<double>& world,
+             double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+             double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+             AlgorithmType algorithm,
+             vector<TBLoc>& path) {
     // modified by Marty to use an actual Graph object
-    ensureWorldCache(world, costFn);
+    WorldCacheEntry* entry = knownCacheEntry(world, costFn);
+    BasicGraph* graph = entryGraph(entry);
+    searchCounters = SearchCounters();
     cout << endl;
 
-    Grid<double>* const pWorld = const_cast<Grid<double>*>(&world);
-    BasicGraph* graph = WORLD_CACHE[pWorld];
     // graph->resetData();   // make the student worry about this
 
     heuristicFunction = heuristicFn;
@@ -173,40 +348,495 @@ shortestPath(TBLoc start,
     cout << "Looking for a path from " << startVertex->name
          << " to " << endVertex->name << "." << endl;
 
-    vector<Vertex*> result;
+    if (algorithm == CONTRACTION_HIERARCHY) {
+        // the hierarchy answers in terms of locations, so no conversion is needed
+        ContractionHierarchy* hierarchy = entryHierarchy(entry, "");
+        cout << "Executing contraction hierarchy query ..." << endl;
+        hierarchy->findPath(start, end, path);
+        cout << "Algorithm complete." << endl;
+        return;
+    }
+
+    if (algorithm == HPA_STAR) {
+        ClusterHierarchy* clusters = entryClusters(entry, heuristicFn);
+        cout << "Executing hierarchical A* algorithm ..." << endl;
+        clusters->findPath(start, end, path);
+        cout << "Algorithm complete." << endl;
+        return;
+    }
+
+    if (algorithm == D_STAR_LITE) {
+        IncrementalPlanner* planner = entryPlanner(entry, heuristicFn);
+        cout << "Executing D* Lite algorithm ..." << endl;
+        if (searchInstrumentation == COUNT_STEPS) {
+            CountingObserver observer;
+            planner->findPath(start, end, path, observer);
+            searchCounters = observer.counters;
+        } else if (searchInstrumentation == NO_INSTRUMENTATION) {
+            NullObserver observer;
+            planner->findPath(start, end, path, observer);
+        } else {
+            ColorObserver observer;
+            planner->findPath(start, end, path, observer);
+        }
+        cout << "Algorithm complete." << endl;
+        return;
+    }
+
+    if (algorithm == ALT) {
+        activeLandmarks = entryLandmarks(entry, 8);
+        Vertex::setHeuristicFunction(landmarkHeuristicAdapter);
+    }
+
+    // pick the build of the search for the instrumentation once, outside its loop
+    if (searchInstrumentation == COUNT_STEPS) {
+        CountingObserver observer;
+        runSearch(algorithm, *graph, startVertex, endVertex, observer);
+        searchCounters = observer.counters;
+    } else if (searchInstrumentation == NO_INSTRUMENTATION) {
+        NullObserver observer;
+        runSearch(algorithm, *graph, startVertex, endVertex, observer);
+    } else {
+        ColorObserver observer;
+        runSearch(algorithm, *graph, startVertex, endVertex, observer);
+    }
+
+    cout << "Algorithm complete." << endl;
+
+    extractPath(endVertex, path);
+}
+
+void setSearchInstrumentation(SearchInstrumentation instrumentation) {
+    searchInstrumentation = instrumentation;
+}
+
+const SearchCounters& lastSearchCounters() {
+    return searchCounters;
+}
+
+void extractPath(Vertex* end, vector<TBLoc>& path) {
+    // measure the path first so that it can be filled in from the back
+    int length = 0;
+    for (Vertex* v = end; v != NULL; v = v->previous) {
+        length++;
+    }
+    path.resize(length);
+    for (Vertex* v = end; v != NULL; v = v->previous) {
+        path[--length] = makeLoc(v->m_row, v->m_col);
+    }
+}
+
+Vector<PathResult>
+shortestPaths(const Vector<TBEdge>& queries,
+              const Grid<double>& world,
+              double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+              double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+              int numThreads) {
+    const CompactGraph* graph = ensureCompactGraph(world, costFn);
+    BatchPathFinder finder(*graph, world, heuristicFn, numThreads);
+    Vector<PathResult> results;
+    finder.findPaths(queries, results);
+    return results;
+}
+
+Grid<double>
+distanceMatrix(const Vector<TBLoc>& sources,
+               const Vector<TBLoc>& targets,
+               const Grid<double>& world,
+               double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+               int numThreads) {
+    const CompactGraph* graph = ensureCompactGraph(world, costFn);
+    BatchPathFinder finder(*graph, world, NULL, numThreads);
+    Grid<double> matrix;
+    finder.findDistances(sources, targets, matrix);
+    return matrix;
+}
+
+Grid<double>
+distanceField(TBLoc source,
+              const Grid<double>& world,
+              double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+              int numThreads) {
+    const CompactGraph* graph = ensureCompactGraph(world, costFn);
+    if (!graph->inBounds(source)) {
+        error(string("Source location is outside the world: ") + vertexName(source.row, source.col, world));
+    }
+    vector<double> distance;
+    deltaStepping(*graph, graph->vertexId(source), distance, numThreads);
+
+    Grid<double> field(world.numRows(), world.numCols());
+    for (int r = 0; r < world.numRows(); r++) {
+        for (int c = 0; c < world.numCols(); c++) {
+            field.set(r, c, distance[graph->vertexId(r, c)]);
+        }
+    }
+    return field;
+}
+
+Set<TBEdge> createMaze(int /* numRows */, int /* numCols */) {
+    Set<TBEdge> set;
+    return set;
+}
+
+/*
+ * Computes a 64-bit FNV-1a style hash of the size and cells of a world.  The
+ * cells are read straight from the grid's row-major storage and mixed in four
+ * independent lanes, so hashing a huge world takes a fraction of a millisecond.
+ */
+static unsigned long long hashWorld(const Grid<double>& world) {
+    const unsigned long long kPrime = 1099511628211ULL;
+    unsigned long long lane0 = 14695981039346656037ULL, lane1 = 1, lane2 = 2, lane3 = 3;
+    int numCells = world.numRows() * world.numCols();
+    if (numCells > 0) {
+        const double* cells = &const_cast<Grid<double>&>(world)[0][0];
+        unsigned long long bits[4];
+        int i = 0;
+        for (; i + 4 <= numCells; i += 4) {
+            memcpy(bits, &cells[i], sizeof(bits));
+            lane0 = (lane0 ^ bits[0]) * kPrime;
+            lane1 = (lane1 ^ bits[1]) * kPrime;
+            lane2 = (lane2 ^ bits[2]) * kPrime;
+            lane3 = (lane3 ^ bits[3]) * kPrime;
+        }
+        for (; i < numCells; i++) {
+            memcpy(bits, &cells[i], sizeof(bits[0]));
+            lane0 = (lane0 ^ bits[0]) * kPrime;
+        }
+    }
+
+    unsigned long long hash = lane0;
+    hash = (hash ^ (unsigned long long) world.numRows()) * kPrime;
+    hash = (hash ^ (unsigned long long) world.numCols()) * kPrime;
+    hash = (hash ^ lane1) * kPrime;
+    hash = (hash ^ lane2) * kPrime;
+    hash = (hash ^ lane3) * kPrime;
+
+    // multiplying only carries changes upwards; fold the high bits back down
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/*
+ * Returns the cache entry for the given world contents and cost function,
+ * creating an empty one (and dropping the least recently used entry if the
+ * cache is full) if there is none yet.
+ */
+static WorldCacheEntry* findCacheEntry(const Grid<double>& world,
+                                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    WorldKey key;
+    key.hash = hashWorld(world);
+    key.costFn = costFn;
+
+    if (!WORLD_CACHE.containsKey(key)) {
+        if (WORLD_CACHE.size() >= kMaxCachedWorlds) {
+            WorldKey oldest = key;
+            unsigned long long oldestUse = cacheClock + 1;
+            foreach (WorldKey cached in WORLD_CACHE) {
+                if (WORLD_CACHE[cached]->lastUse < oldestUse) {
+                    oldest = cached;
+                    oldestUse = WORLD_CACHE[cached]->lastUse;
+                }
+            }
+            deleteCacheEntry(WORLD_CACHE[oldest]);
+            WORLD_CACHE.remove(oldest);
+            forgetGrids(oldest);
+        }
+
+        WorldCacheEntry* entry = new WorldCacheEntry();
+        entry->key = key;
+        entry->world = world;
+        entry->graph = NULL;
+        entry->compact = NULL;
+        entry->hierarchy = NULL;
+        entry->landmarks = NULL;
+        entry->planner = NULL;
+        entry->clusters = NULL;
+        WORLD_CACHE[key] = entry;
+    }
+
+    LAST_KEYS[const_cast<Grid<double>*>(&world)] = key;
+    WorldCacheEntry* entry = WORLD_CACHE[key];
+    entry->lastUse = ++cacheClock;
+    return entry;
+}
+
+/*
+ * Returns the cache entry for a grid, without hashing it if it still holds the
+ * cells of the entry it was last found under: comparing them with the entry's
+ * copy reads the two arrays straight through, which is several times cheaper
+ * than hashing.  A grid not seen before, changed since, or seen with another
+ * cost function is looked up by its contents with findCacheEntry instead.
+ */
+static WorldCacheEntry* knownCacheEntry(const Grid<double>& world,
+                                        double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    Grid<double>* const pWorld = const_cast<Grid<double>*>(&world);
+    if (LAST_KEYS.containsKey(pWorld)) {
+        WorldKey key = LAST_KEYS[pWorld];
+        if (key.costFn == costFn && WORLD_CACHE.containsKey(key)) {
+            WorldCacheEntry* entry = WORLD_CACHE[key];
+            if (sameCells(world, entry->world)) {
+                entry->lastUse = ++cacheClock;
+                return entry;
+            }
+        }
+    }
+    return findCacheEntry(world, costFn);
+}
+
+/*
+ * Returns whether two grids have the same size and bit-for-bit the same cells,
+ * as the hash of hashWorld sees them.
+ */
+static bool sameCells(const Grid<double>& world, const Grid<double>& other) {
+    if (world.numRows() != other.numRows() || world.numCols() != other.numCols()) {
+        return false;
+    }
+    int numCells = world.numRows() * world.numCols();
+    return numCells == 0
+            || memcmp(&const_cast<Grid<double>&>(world)[0][0], &const_cast<Grid<double>&>(other)[0][0],
+                      numCells * sizeof(double)) == 0;
+}
+
+/*
+ * Drops the grids last found under the given key, whose entry is leaving the
+ * cache, so that LAST_KEYS only refers to cached worlds.
+ */
+static void forgetGrids(const WorldKey& key) {
+    Vector<Grid<double>*> stale;
+    foreach (Grid<double>* grid in LAST_KEYS) {
+        if (LAST_KEYS[grid] == key) {
+            stale.add(grid);
+        }
+    }
+    foreach (Grid<double>* grid in stale) {
+        LAST_KEYS.remove(grid);
+    }
+}
+
+/*
+ * Returns a name that identifies a cost function across runs, or "" if it is
+ * not one of those in costs.h, as the address of any other could change.
+ */
+static string costFunctionName(double costFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    if (costFn == terrainCost) {
+        return "terrain";
+    } else if (costFn == mazeCost) {
+        return "maze";
+    }
+    return "";
+}
+
+/*
+ * Returns the name of the file in the cache directory that holds a structure
+ * of the given kind for the given key, or "" if nothing is to be persisted:
+ * when no directory is set, or when the cost function has no name that
+ * identifies it across runs.
+ */
+static string cacheFileName(const WorldKey& key, const string& extension) {
+    string costName = costFunctionName(key.costFn);
+    if (cacheDirectory.empty() || costName.empty()) {
+        return "";
+    }
+
+    ostringstream name;
+    name << cacheDirectory << "/" << hex << setw(16) << setfill('0') << key.hash
+         << "-" << costName << extension;
+    return name.str();
+}
+
+/*
+ * Returns the BasicGraph of a cache entry, building it if needed.
+ */
+static BasicGraph* entryGraph(WorldCacheEntry* entry) {
+    if (entry->graph == NULL) {
+        cout << "Preparing world model ..." << endl;
+        entry->graph = gridToGraph(entry->world, entry->key.costFn);
+        cout << "World model completed." << endl;
+    }
+    return entry->graph;
+}
+
+/*
+ * Returns the CompactGraph of a cache entry.  If the entry has no BasicGraph
+ * yet, the compact graph is first looked for in the cache directory, which
+ * saves building the BasicGraph altogether; a newly built one is saved there.
+ */
+static CompactGraph* entryCompactGraph(WorldCacheEntry* entry) {
+    if (entry->compact == NULL) {
+        string file = cacheFileName(entry->key, ".tbcg");
+        CompactGraph* compact = new CompactGraph();
+        if (entry->graph == NULL && !file.empty() && compact->load(file)
+                && compact->numRows() == entry->world.numRows()
+                && compact->numCols() == entry->world.numCols()) {
+            cout << "Loaded world model from " << file << "." << endl;
+        } else {
+            delete compact;
+            compact = new CompactGraph(*entryGraph(entry));
+            if (!file.empty() && !compact->save(file)) {
+                cerr << "Unable to write world model to " << file << endl;
+            }
+        }
+        entry->compact = compact;
+    }
+    return entry->compact;
+}
+
+/*
+ * Returns the ContractionHierarchy of a cache entry, loading or building it if
+ * needed; see ensureContractionHierarchy.  The file must have been saved for
+ * the same world hash and cost function, so a hierarchy built with a cost
+ * function that has no name is never loaded.
+ */
+static ContractionHierarchy* entryHierarchy(WorldCacheEntry* entry, const string& filename) {
+    if (entry->hierarchy == NULL) {
+        string file = filename.empty() ? cacheFileName(entry->key, ".tbch") : filename;
+        string costName = costFunctionName(entry->key.costFn);
+        ContractionHierarchy* hierarchy = new ContractionHierarchy();
+        if (file.empty() || costName.empty() || !hierarchy->load(file, entry->key.hash, costName)
+                || hierarchy->numRows() != entry->world.numRows()
+                || hierarchy->numCols() != entry->world.numCols()) {
+            const CompactGraph* compact = entryCompactGraph(entry);
+            cout << "Preparing contraction hierarchy ..." << endl;
+            delete hierarchy;
+            hierarchy = new ContractionHierarchy(*compact);
+            if (!file.empty() && !hierarchy->save(file, entry->key.hash, costName)) {
+                cerr << "Unable to write contraction hierarchy to " << file << endl;
+            }
+            cout << "Contraction hierarchy completed." << endl;
+        }
+        entry->hierarchy = hierarchy;
+    }
+    return entry->hierarchy;
+}
+
+/*
+ * Returns the Landmarks of a cache entry, building them if needed.
+ */
+static Landmarks* entryLandmarks(WorldCacheEntry* entry, int count) {
+    if (entry->landmarks == NULL) {
+        const CompactGraph* compact = entryCompactGraph(entry);
+        cout << "Preparing landmarks ..." << endl;
+        entry->landmarks = new Landmarks(*compact, count);
+        cout << "Landmarks completed." << endl;
+    }
+    return entry->landmarks;
+}
+
+/*
+ * Returns the IncrementalPlanner of a cache entry, creating it if needed.
+ */
+static IncrementalPlanner* entryPlanner(WorldCacheEntry* entry,
+                                        double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    if (entry->planner == NULL) {
+        entry->planner = new IncrementalPlanner(*entryGraph(entry), entry->world, heuristicFn);
+    }
+    return entry->planner;
+}
+
+/*
+ * Returns the ClusterHierarchy of a cache entry, building it if needed.
+ */
+static ClusterHierarchy* entryClusters(WorldCacheEntry* entry,
+                                       double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    if (entry->clusters == NULL) {
+        const CompactGraph* compact = entryCompactGraph(entry);
+        cout << "Preparing cluster hierarchy ..." << endl;
+        entry->clusters = new ClusterHierarchy(*compact, entry->world, heuristicFn);
+        cout << "Cluster hierarchy completed (" << entry->clusters->numTransitions()
+             << " transitions)." << endl;
+    }
+    return entry->clusters;
+}
+
+/*
+ * Frees a cache entry and everything built for it.  The caller removes it
+ * from WORLD_CACHE.
+ */
+static void deleteCacheEntry(WorldCacheEntry* entry) {
+    flushDerivedCaches(entry);
+    delete entry->planner;
+    delete entry->graph;
+    delete entry;
+}
+
+/*
+ * Frees the structures built from the whole graph of a cache entry, which go
+ * stale as soon as any arc of the graph changes.
+ */
+static void flushDerivedCaches(WorldCacheEntry* entry) {
+    if (activeLandmarks == entry->landmarks) {
+        activeLandmarks = NULL;
+    }
+    delete entry->compact;
+    delete entry->hierarchy;
+    delete entry->landmarks;
+    delete entry->clusters;
+    entry->compact = NULL;
+    entry->hierarchy = NULL;
+    entry->landmarks = NULL;
+    entry->clusters = NULL;
+}
+
+/*
+ * Brings the arc between two neighboring cells in line with the cost function,
+ * adding it if it has become passable and removing it if it no longer is.
+ */
+static void updateArc(BasicGraph* graph, const Grid<double>& world,
+                      double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                      TBLoc from, TBLoc to) {
+    Vertex* v = graph->getVertex(vertexName(from.row, from.col, world));
+    Vertex* neighbor = graph->getVertex(vertexName(to.row, to.col, world));
+    double cost = costFn(from, to, world);
+    Edge* e = graph->getArc(v, neighbor);
+    if (cost == POSITIVE_INFINITY) {
+        if (e != NULL) {
+            graph->removeArc(e);
+            delete e;
+        }
+    } else if (e == NULL) {
+        e = new Edge(v, neighbor, cost);
+        e->m_startRow = from.row;
+        e->m_startCol = from.col;
+        e->m_finishRow = to.row;
+        e->m_finishCol = to.col;
+        graph->addEdge(e);
+    } else {
+        e->cost = cost;
+    }
+}
+
+/*
+ * Runs one of the searches of trailblazer.cpp that work on the BasicGraph,
+ * reporting its steps to the given observer.
+ */
+template <typename Observer>
+static void runSearch(AlgorithmType algorithm, BasicGraph& graph, Vertex* start, Vertex* end,
+                      Observer& observer) {
     switch (algorithm) {
     case BFS:
         cout << "Executing breadth-first search algorithm ..." << endl;
-        result = breadthFirstSearch(*graph, startVertex, endVertex);
+        searchBreadthFirst(graph, start, end, observer);
         break;
     case DIJKSTRA:
         cout << "Executing Dijkstra's algorithm ..." << endl;
-        result = dijkstrasAlgorithm(*graph, startVertex, endVertex);
+        searchDijkstra(graph, start, end, observer);
         break;
     case A_STAR:
         cout << "Executing A* algorithm ..." << endl;
-        result = aStar(*graph, startVertex, endVertex);
+        searchAStar(graph, start, end, observer);
+        break;
+    case ALT:
+        cout << "Executing A* algorithm with landmarks ..." << endl;
+        searchAStar(graph, start, end, observer);
         break;
     case DFS:
     default:
         cout << "Executing depth-first search algorithm ..." << endl;
-        result = depthFirstSearch(*graph, startVertex, endVertex);
+        searchDepthFirst(graph, start, end, observer);
         break;
     }
-
-    cout << "Algorithm complete." << endl;
-
-    // convert vector<Vertex*> to Vector<Loc>
-    Vector<TBLoc> locResult;
-    foreach (Vertex* v in result) {
-        locResult.add(makeLoc(v->m_row, v->m_col));
-    }
-    return locResult;
-}
-
-Set<TBEdge> createMaze(int /* numRows */, int /* numCols */) {
-    Set<TBEdge> set;
-    return set;
 }
 
 static double heuristicAdapter(Node* const from, Node* const to, const Grid<double>& world) {
@@ -218,6 +848,16 @@ static double heuristicAdapter(Node* const from, Node* const to, const Grid<doub
     }
 }
 
+static double landmarkHeuristicAdapter(Node* const from, Node* const to, const Grid<double>& world) {
+    // both estimates are admissible, so the larger one is too
+    double estimate = heuristicAdapter(from, to, world);
+    if (activeLandmarks != NULL) {
+        estimate = max(estimate, activeLandmarks->lowerBound(makeLoc(from->m_row, from->m_col),
+                                                             makeLoc(to->m_row, to->m_col)));
+    }
+    return estimate;
+}
+
 string vertexName(int r, int c, const Grid<double>& world) {
     // zero-pad the number of rows/cols for better alphabetic sorting
     int digits = 0;
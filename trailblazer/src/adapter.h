@@ -20,9 +20,18 @@
 #ifndef _adapter_h
 #define _adapter_h
 
+#include <vector>
 #include "grid.h"
 #include "set.h"
 #include "BasicGraph.h"
+#include "BatchPathFinder.h"
+#include "ClusterHierarchy.h"
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include "DeltaStepping.h"
+#include "IncrementalPlanner.h"
+#include "Landmarks.h"
+#include "SearchObserver.h"
 #include "types.h"
 
 /* Type: AlgorithmType
@@ -34,7 +43,24 @@ enum AlgorithmType {
     BFS,
     DFS,
     DIJKSTRA,
-    A_STAR
+    A_STAR,
+    CONTRACTION_HIERARCHY,
+    ALT,
+    D_STAR_LITE,
+    HPA_STAR
+};
+
+/* Type: SearchInstrumentation
+ *
+ * What the BFS, DFS, Dijkstra, A*, ALT and D* Lite searches of shortestPath do
+ * at each step: colour the cells for the GUI (the default), count the steps, or
+ * nothing at all.  The choice is made once per search, and the searches are
+ * compiled separately for each, so an uninstrumented search pays nothing.
+ */
+enum SearchInstrumentation {
+    COLOR_CELLS,
+    COUNT_STEPS,
+    NO_INSTRUMENTATION
 };
 
 /*
@@ -53,6 +79,85 @@ shortestPath(TBLoc start,
              double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
              AlgorithmType algorithm = AUTODETECT);
 
+/*
+ * Same as shortestPath above, but writes the path into a buffer owned by the
+ * caller instead of returning a new Vector.  The buffer keeps its capacity, so
+ * reusing it for many searches avoids allocating.
+ */
+void
+shortestPath(TBLoc start,
+             TBLoc end,
+             const Grid<double>& world,
+             double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+             double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+             AlgorithmType algorithm,
+             vector<TBLoc>& path);
+
+/*
+ * Sets what the searches of shortestPath do at each step; see
+ * SearchInstrumentation.  Headless callers should not leave it at COLOR_CELLS.
+ */
+void setSearchInstrumentation(SearchInstrumentation instrumentation);
+
+/*
+ * Returns the counts of the steps of the last search run by shortestPath with
+ * COUNT_STEPS instrumentation.  For D* Lite they count only the repairs that
+ * search made to the tree kept from earlier queries.  They are all zero for the
+ * algorithms that do not search the BasicGraph (contraction hierarchy and HPA*).
+ */
+const SearchCounters& lastSearchCounters();
+
+/*
+ * Writes the path that the last search left in the previous pointers of the
+ * vertices, from its first vertex to end, into the given buffer as locations.
+ * Takes time linear in the length of the path.
+ */
+void extractPath(Vertex* end, vector<TBLoc>& path);
+
+/*
+ * Finds the shortest path for every (start, end) pair in the given list, using
+ * A* search with the given heuristic on worker threads that share the cached
+ * graph of the world.  Result i belongs to query i; unreachable ends give an
+ * empty path with infinite cost.  With numThreads 0, one thread per hardware
+ * thread is used.
+ * Callers that submit batches repeatedly can keep a BatchPathFinder on
+ * ensureCompactGraph(world, costFn) to reuse its threads.
+ */
+Vector<PathResult>
+shortestPaths(const Vector<TBEdge>& queries,
+              const Grid<double>& world,
+              double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+              double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+              int numThreads = 0);
+
+/*
+ * Computes the cost of the cheapest path from every source to every target,
+ * returned as a matrix with one row per source and one column per target.
+ * Runs one Dijkstra search per source on worker threads that share the cached
+ * graph of the world, each stopping as soon as all targets are settled, which
+ * is far cheaper than a shortestPath call per pair.  Unreachable targets and
+ * locations outside the world get infinity.  With numThreads 0, one thread per
+ * hardware thread is used.
+ */
+Grid<double>
+distanceMatrix(const Vector<TBLoc>& sources,
+               const Vector<TBLoc>& targets,
+               const Grid<double>& world,
+               double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+               int numThreads = 0);
+
+/*
+ * Computes the cost of the cheapest path from the source to every location of
+ * the world, using the parallel delta-stepping algorithm on the cached graph.
+ * The result has the size of the world; unreachable locations get infinity.
+ * With numThreads 0, one thread per hardware thread is used.
+ */
+Grid<double>
+distanceField(TBLoc source,
+              const Grid<double>& world,
+              double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+              int numThreads = 0);
+
 // Support functions called by the GUI to improve loading times for large graphs.
 
 /*
@@ -77,10 +182,104 @@ BasicGraph* gridToGraph(const Grid<double>& world,
  * result to be used on future calls.
  * This is done to improve runtime when very large/huge mazes and terrains are
  * loaded and then searched multiple times by the user.
+ *
+ * The cache is keyed by a hash of the world's size and cell values together
+ * with the cost function, not by the address of the grid, so reloading the
+ * same world finds its structures again and a grid whose contents changed is
+ * never answered from stale ones.  Each entry works on its own copy of the
+ * world.  At most a handful of worlds are kept; when another one is added,
+ * the least recently used entry is freed, along with everything built for it.
+ *
+ * Every function taking a world finds its entry this way.  A grid already
+ * found is only compared with the entry's copy, which is cheaper than hashing
+ * it again; callers that query an unchanging world in a tight loop can skip
+ * even that by keeping the structure returned by ensureCompactGraph or
+ * ensureContractionHierarchy.
  */
 void ensureWorldCache(const Grid<double>& world,
                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
 
+/*
+ * Makes sure that the given world has been converted into a CompactGraph,
+ * an immutable array-based copy of its BasicGraph, and returns it.
+ * If a cache directory is set and holds the compact graph of this world, it is
+ * loaded from there without building the BasicGraph; otherwise it is built and
+ * written there.
+ * The compact graph is owned by the cache and freed by flushWorldCache or when
+ * its world is evicted.
+ */
+const CompactGraph* ensureCompactGraph(const Grid<double>& world,
+                                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world));
+
+/*
+ * Makes sure that a contraction hierarchy has been built for the given world,
+ * whose graph is taken from (or added to) the world cache, and returns it.
+ * If a filename is given, the hierarchy is loaded from that file when it was
+ * saved for a world of the same contents with the same cost function, which
+ * must be one of those in costs.h; otherwise it is built and then written to
+ * the file so that later runs can skip the preprocessing.  Without a filename, a file in
+ * the cache directory named after the world's hash is used, if one is set.
+ * The hierarchy is owned by the cache and freed by flushWorldCache or when its
+ * world is evicted.
+ */
+ContractionHierarchy* ensureContractionHierarchy(const Grid<double>& world,
+                                                 double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                                 const string& filename = "");
+
+/*
+ * Makes sure that landmarks for the ALT heuristic have been picked for the
+ * given world, and returns them.  The ALT algorithm type runs A* search with
+ * the larger of the given heuristic function and the landmark lower bound.
+ * The landmarks are owned by the cache and freed by flushWorldCache or when
+ * their world is evicted.
+ */
+Landmarks* ensureLandmarks(const Grid<double>& world,
+                           double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                           int count = 8);
+
+/*
+ * Makes sure that an incremental (D* Lite) planner exists for the given world,
+ * and returns it.  The D_STAR_LITE algorithm type answers queries with it, so
+ * repeated queries to the same end only repair what changed in between.
+ * The planner is owned by the cache and freed by flushWorldCache or when its
+ * world is evicted.
+ */
+IncrementalPlanner* ensureIncrementalPlanner(const Grid<double>& world,
+                                             double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                             double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world));
+
+/*
+ * Makes sure that a cluster hierarchy for hierarchical A* (HPA*) has been built
+ * for the given world, and returns it.  The HPA_STAR algorithm type answers
+ * queries with it; its paths are near-optimal rather than optimal.
+ * The hierarchy is owned by the cache and freed by flushWorldCache or when its
+ * world is evicted.
+ */
+ClusterHierarchy* ensureClusterHierarchy(const Grid<double>& world,
+                                         double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                         double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world));
+
+/*
+ * Tells the cache that the given cells of the world have new values.  Instead
+ * of rebuilding the cached graph, only the arcs into and out of those cells are
+ * updated, added or removed, and the incremental planner is told to repair its
+ * tree.  The compact graph, contraction hierarchy, landmarks and cluster
+ * hierarchy of the world are dropped, as they depend on the whole graph, and
+ * are rebuilt when next needed; pointers to them must not be used after this
+ * call.  The world is then cached under its new contents.
+ */
+void updateWorldCells(const Grid<double>& world,
+                      double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                      const Vector<TBLoc>& cells);
+
+/*
+ * Sets the directory in which the compact graphs and contraction hierarchies
+ * of worlds are kept between runs, one file each, named after the hash of the
+ * world and its cost function.  Only the cost functions of costs.h are
+ * persisted.  An empty string, the default, turns persistence off.
+ */
+void setWorldCacheDirectory(const string& directory);
+
 /*
  * Removes all entries from the internal cache of BasicGraphs and frees
  * any memory associated with them.
@@ -0,0 +1,786 @@
+/**
+ * Headless benchmark of the path-finding algorithms on the world files in res/.
+ * Runs every chosen algorithm on the same reproducible random queries and
+ * reports load time, expanded vertices, path cost, latency percentiles and peak
+ * memory.  World files may be text or binary (.tbw, see worldconvert.cpp).
+ * It needs no display: build it from src/ together with every .cpp file there
+ * except trailblazergui.cpp, plus error, random, strlib and tokenscanner from
+ * the Stanford library, and put src/ and lib/StanfordCPPLib on the include path.
+ *
+ * trailblazergui.h must not be included here, as this file has its own main.
+ *
+ * Usage: trailblazerbench [-q queries] [-s seed] [-a algorithm,...] [-cache dir] [-j threads] [-grid]
+ *                         [-changes cells] [-matrix locations] [-field] [-batch] [-csv] world...
+ * Algorithms: dfs, bfs, dijkstra, astar, alt, ch, dstar, hpa.  DFS and BFS ignore
+ * costs and are only run on terrains when asked for with -a.  Contraction
+ * hierarchy and HPA* queries do not colour cells, so they report no expanded
+ * vertices.  With -cache, compact graphs and contraction hierarchies are kept
+ * in the given directory between runs (see setWorldCacheDirectory).  With
+ * -grid, A* on the compact graph (compactAStar) and on the implicit grid of the
+ * cost planes (gridAStar) are timed as well, as "compact" and "grid", and the
+ * run fails if they disagree on the cost of any query; they report no expanded
+ * vertices either.  With -changes, D* Lite is run once more as "repair", with
+ * all queries going to the same end and the given number of random cells of
+ * the world changed through updateWorldCells before each, so that every query
+ * repairs the tree of the one before; the run fails if any of its costs differs
+ * from that of compactAStar on the changed world.  With -matrix, distanceMatrix
+ * is run on the given number of random locations, on the threads of -j (every
+ * hardware thread by default), as "matrix", and compactAStar on every pair of
+ * them as "pairwise"; the run fails if any entry of the matrix differs from the
+ * cost of its pair.  With -field, the distance field of one location is
+ * computed by distanceField on one thread and on the threads of -j, as "field1"
+ * and "fieldN" with N the number of threads, and by compactDijkstra on the
+ * calling thread as "seqfield", each cell of the world counting as a query; the
+ * run fails if the fields differ.  With -batch, the queries are answered by
+ * shortestPaths on one thread and on the threads of -j, as "batch1" and
+ * "batchN", and the run fails if any cost found on N threads differs from the
+ * one found on one.  Rows that answer all their queries at once, such as the
+ * matrix, the fields and the batches, give each query an equal share of the
+ * time.  Queries/s is the number of queries of a row over its total time.  Total ms is the time
+ * of all queries of a row together.
+ * @file trailblazerbench.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "CostPlanes.h"
+#include "SearchState.h"
+#include "adapter.h"
+#include "costs.h"
+#include "error.h"
+#include "worldfile.h"
+
+// error.h renames main so that the library can start the GUI first; there is none here
+#undef main
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/*
+ * The settings given on the command line.
+ */
+struct Options {
+    int numQueries = 100;
+    unsigned int seed = 1;
+    vector<AlgorithmType> algorithms;   // empty to run the default set
+    bool csv = false;
+    bool compareGrid = false;   // also time and check the searches on the compact graph and the grid
+    int numChanges = 0;         // cells changed before each D* Lite repair query; 0 to run none
+    int matrixSize = 0;         // locations of the distance matrix; 0 to build none
+    bool compareField = false;  // also time and check the distance fields
+    bool compareBatch = false;  // also time and check the queries run as batches
+    int numThreads = 0;         // threads of the parallel modes; 0 for one per hardware thread
+    string cacheDirectory;   // empty to keep nothing between runs
+    vector<string> worldFiles;
+};
+
+/*
+ * The measurements of one algorithm on one world.
+ */
+struct AlgorithmStats {
+    int found = 0;
+    long long expanded = 0;
+    double totalCost = 0;
+    double prepareMs = 0;
+    vector<double> latencies;   // microseconds per query
+};
+
+static const AlgorithmType ALL_ALGORITHMS[] = { DFS, BFS, DIJKSTRA, A_STAR, ALT, CONTRACTION_HIERARCHY, D_STAR_LITE, HPA_STAR };
+static const char* const ALGORITHM_NAMES[] = { "dfs", "bfs", "dijkstra", "astar", "alt", "ch", "dstar", "hpa" };
+static const int NUM_ALGORITHMS = 8;
+
+/**
+ * Stands in for the GUI, which the searches would colour cells in; they are
+ * run with counting instrumentation here, so nothing is drawn
+ */
+void colorCell(Grid<double>& /* world */, TBLoc /* loc */, Color /* locColor */) {
+}
+
+/**
+ * Gives the short name of an algorithm, as used on the command line
+ * @param algorithm The algorithm
+ * @return The name
+ */
+static string algorithmName(AlgorithmType algorithm) {
+    for (int i = 0; i < NUM_ALGORITHMS; i++) {
+        if (ALL_ALGORITHMS[i] == algorithm)
+            return ALGORITHM_NAMES[i];
+    }
+    return "?";
+}
+
+/**
+ * Gives the peak memory use of the process so far
+ * @return The peak resident set size in megabytes, 0 where it is unknown
+ */
+static double peakMemoryMB() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+#endif
+}
+
+/**
+ * Gives the time passed since a point in time
+ * @param start The point in time
+ * @return The time in milliseconds
+ */
+static double millisecondsSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+/**
+ * Gives a percentile of sorted values
+ * @param sorted The values in ascending order, not empty
+ * @param percent The percentile, 0-100
+ * @return The value below which the given percentage of the values lie
+ */
+static double percentile(const vector<double>& sorted, double percent) {
+    int index = (int) ceil(percent / 100 * sorted.size()) - 1;
+    return sorted[max(0, min(index, (int) sorted.size() - 1))];
+}
+
+/**
+ * Picks random queries between cells that can be stood on
+ * @param world The world to pick cells in
+ * @param worldType The type of the world; walls of mazes are never picked
+ * @param count The number of queries
+ * @param seed The seed of the random generator, so that runs can be repeated
+ * @return The start and end of each query
+ */
+static vector<TBEdge> makeQueries(const Grid<double>& world, WorldType worldType, int count, unsigned int seed) {
+    vector<TBLoc> cells;
+    for (int row = 0; row < world.numRows(); row++) {
+        for (int col = 0; col < world.numCols(); col++) {
+            if (worldType == TERRAIN_WORLD || world.get(row, col) != kMazeWall)
+                cells.push_back(makeLoc(row, col));
+        }
+    }
+
+    vector<TBEdge> queries;
+    if (cells.empty())
+        return queries;
+
+    mt19937 random(seed);
+    for (int i = 0; i < count; i++) {
+        TBLoc start = cells[random() % cells.size()];
+        TBLoc end = cells[random() % cells.size()];
+        queries.push_back(makeEdge(start, end));
+    }
+    return queries;
+}
+
+/**
+ * Tells whether two path costs found by different searches agree.  Searches on
+ * the compact graph keep costs in single precision, so they may differ by rounding
+ * @param cost The cost found by one search, INFINITY if it found no path
+ * @param other The cost found by the other
+ * @return True if both found no path, or paths whose costs match up to rounding
+ */
+static bool sameCost(double cost, double other) {
+    if (cost == INFINITY || other == INFINITY)
+        return cost == other;
+    return fabs(cost - other) <= 1e-4 * max(1.0, fabs(cost));
+}
+
+/**
+ * Runs one algorithm on every query
+ * @param algorithm The algorithm to run
+ * @param queries The start and end of each query
+ * @param world The world to search
+ * @param costFn The cost function of the world
+ * @param heuristicFn The heuristic of the world
+ * @return The measurements
+ */
+static AlgorithmStats runAlgorithm(AlgorithmType algorithm, const vector<TBEdge>& queries, const Grid<double>& world,
+                                   double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                                   double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world)) {
+    AlgorithmStats stats;
+
+    // Preprocessing is timed apart from the queries
+    Clock::time_point prepareStart = Clock::now();
+    if (algorithm == ALT)
+        ensureLandmarks(world, costFn);
+    else if (algorithm == CONTRACTION_HIERARCHY)
+        ensureContractionHierarchy(world, costFn);
+    else if (algorithm == HPA_STAR)
+        ensureClusterHierarchy(world, costFn, heuristicFn);
+    stats.prepareMs = millisecondsSince(prepareStart);
+
+    vector<TBLoc> path;
+    for (const TBEdge& query : queries) {
+        Clock::time_point queryStart = Clock::now();
+        shortestPath(query.start, query.end, world, costFn, heuristicFn, algorithm, path);
+        stats.latencies.push_back(millisecondsSince(queryStart) * 1000);
+        stats.expanded += lastSearchCounters().settled;
+
+        // A search that fails may still return the end on its own
+        if (path.empty() || path.front() != query.start || path.back() != query.end)
+            continue;
+        stats.found++;
+        for (size_t i = 1; i < path.size(); i++)
+            stats.totalCost += costFn(path[i - 1], path[i], world);
+    }
+
+    sort(stats.latencies.begin(), stats.latencies.end());
+    return stats;
+}
+
+/**
+ * Runs A* search on the compact graph of a world and on the implicit grid of its
+ * cost planes, on the same queries, and checks that both find paths of the same
+ * cost
+ * @param queries The (start, end) pairs to search for
+ * @param world The world, whose compact graph must already be cached
+ * @param costFn The cost of moving between two neighboring locations
+ * @param heuristicFn The estimate of the cost between two locations
+ * @param compactStats Receives the measurements of compactAStar
+ * @param gridStats Receives the measurements of gridAStar; building the cost
+ *                  planes counts as its preprocessing
+ * @return False if the costs of some query differ by more than rounding
+ */
+static bool compareGridSearch(const vector<TBEdge>& queries, const Grid<double>& world,
+                              double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                              double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                              AlgorithmStats& compactStats, AlgorithmStats& gridStats) {
+    const CompactGraph* graph = ensureCompactGraph(world, costFn);
+    Clock::time_point prepareStart = Clock::now();
+    CostPlanes planes(world, costFn);
+    gridStats.prepareMs = millisecondsSince(prepareStart);
+
+    SearchState state(graph->numVertices());
+    bool isAgreed = true;
+    for (const TBEdge& query : queries) {
+        int start = graph->vertexId(query.start);
+        int end = graph->vertexId(query.end);
+
+        Clock::time_point compactStart = Clock::now();
+        double compactCost = compactAStar(*graph, state, start, end, heuristicFn, world);
+        compactStats.latencies.push_back(millisecondsSince(compactStart) * 1000);
+
+        Clock::time_point gridStart = Clock::now();
+        double gridCost = gridAStar(planes, state, start, end, heuristicFn, world);
+        gridStats.latencies.push_back(millisecondsSince(gridStart) * 1000);
+
+        if (compactCost != INFINITY) {
+            compactStats.found++;
+            compactStats.totalCost += compactCost;
+        }
+        if (gridCost != INFINITY) {
+            gridStats.found++;
+            gridStats.totalCost += gridCost;
+        }
+        if (!sameCost(compactCost, gridCost))
+            isAgreed = false;
+    }
+
+    sort(compactStats.latencies.begin(), compactStats.latencies.end());
+    sort(gridStats.latencies.begin(), gridStats.latencies.end());
+    return isAgreed;
+}
+
+/**
+ * Runs D* Lite queries from the starts of the given queries to one end on a copy
+ * of a world, changing random cells of the copy through updateWorldCells before
+ * each query, so that each repairs the tree the query before left behind.  Each
+ * cost is checked against that of compactAStar on the changed world
+ * @param queries The queries whose starts to search from; all go to the end of the first
+ * @param world The world; it is copied, not changed
+ * @param numChanges The number of cells changed before each query; the end is never changed
+ * @param seed The seed of the random generator, so that runs can be repeated
+ * @param costFn The cost function of the world
+ * @param heuristicFn The heuristic of the world
+ * @param stats Receives the measurements of the repaired queries; planning to
+ *              the end the first time counts as preprocessing
+ * @return False if D* Lite and compactAStar disagree on the cost of some query
+ */
+static bool runRepairs(const vector<TBEdge>& queries, const Grid<double>& world, int numChanges, unsigned int seed,
+                       double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                       double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                       AlgorithmStats& stats) {
+    if (queries.empty())
+        return true;
+
+    Grid<double> changing = world;
+    TBLoc end = queries[0].end;
+    vector<TBLoc> path;
+    Clock::time_point prepareStart = Clock::now();
+    shortestPath(queries[0].start, end, changing, costFn, heuristicFn, D_STAR_LITE, path);
+    stats.prepareMs = millisecondsSince(prepareStart);
+
+    // Changed cells take the values of other random cells, so a maze stays a maze
+    mt19937 random(seed);
+    SearchState state;
+    bool isAgreed = true;
+    for (const TBEdge& query : queries) {
+        Vector<TBLoc> cells;
+        while (cells.size() < numChanges) {
+            TBLoc cell = makeLoc(random() % world.numRows(), random() % world.numCols());
+            TBLoc donor = makeLoc(random() % world.numRows(), random() % world.numCols());
+            if (cell == end)
+                continue;
+            changing.set(cell.row, cell.col, world.get(donor.row, donor.col));
+            cells.add(cell);
+        }
+        updateWorldCells(changing, costFn, cells);
+
+        Clock::time_point queryStart = Clock::now();
+        shortestPath(query.start, end, changing, costFn, heuristicFn, D_STAR_LITE, path);
+        stats.latencies.push_back(millisecondsSince(queryStart) * 1000);
+        stats.expanded += lastSearchCounters().settled;
+
+        double cost = INFINITY;
+        if (!path.empty() && path.front() == query.start && path.back() == end) {
+            cost = 0;
+            for (size_t i = 1; i < path.size(); i++)
+                cost += costFn(path[i - 1], path[i], changing);
+            stats.found++;
+            stats.totalCost += cost;
+        }
+
+        const CompactGraph* graph = ensureCompactGraph(changing, costFn);
+        state.resize(graph->numVertices());
+        double expected = compactAStar(*graph, state, graph->vertexId(query.start), graph->vertexId(end),
+                                       heuristicFn, changing);
+        if (!sameCost(cost, expected))
+            isAgreed = false;
+    }
+
+    sort(stats.latencies.begin(), stats.latencies.end());
+    return isAgreed;
+}
+
+/**
+ * Builds the distance matrix of random locations of a world with distanceMatrix,
+ * and checks every entry against the cost compactAStar finds for its pair
+ * @param locations The locations, both the sources and the targets of the matrix
+ * @param world The world, whose compact graph must already be cached
+ * @param numThreads The threads to build the matrix on; 0 for one per hardware thread
+ * @param costFn The cost function of the world
+ * @param heuristicFn The heuristic of the world, for the pairwise searches
+ * @param matrixStats Receives the measurements of the matrix, one query per entry
+ * @param pairStats Receives the measurements of compactAStar on each pair
+ * @return False if some entry differs from the cost of its pair
+ */
+static bool compareMatrix(const Vector<TBLoc>& locations, const Grid<double>& world, int numThreads,
+                          double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                          double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                          AlgorithmStats& matrixStats, AlgorithmStats& pairStats) {
+    int count = locations.size();
+    Clock::time_point matrixStart = Clock::now();
+    Grid<double> matrix = distanceMatrix(locations, locations, world, costFn, numThreads);
+    double matrixUs = millisecondsSince(matrixStart) * 1000;
+    matrixStats.latencies.assign(count * count, count == 0 ? 0 : matrixUs / (count * count));
+
+    const CompactGraph* graph = ensureCompactGraph(world, costFn);
+    SearchState state(graph->numVertices());
+    bool isAgreed = true;
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+            Clock::time_point pairStart = Clock::now();
+            double cost = compactAStar(*graph, state, graph->vertexId(locations[i]), graph->vertexId(locations[j]),
+                                       heuristicFn, world);
+            pairStats.latencies.push_back(millisecondsSince(pairStart) * 1000);
+
+            if (matrix.get(i, j) != INFINITY) {
+                matrixStats.found++;
+                matrixStats.totalCost += matrix.get(i, j);
+            }
+            if (cost != INFINITY) {
+                pairStats.found++;
+                pairStats.totalCost += cost;
+            }
+            if (!sameCost(matrix.get(i, j), cost))
+                isAgreed = false;
+        }
+    }
+
+    sort(pairStats.latencies.begin(), pairStats.latencies.end());
+    return isAgreed;
+}
+
+/**
+ * Computes the distance field of a location with distanceField on one thread and
+ * on the given number of threads, and checks both against the field that
+ * compactDijkstra computes on the calling thread
+ * @param source The location to compute the distances from
+ * @param world The world, whose compact graph must already be cached
+ * @param numThreads The threads of the parallel field; 0 for one per hardware thread
+ * @param costFn The cost function of the world
+ * @param fieldStats Receives the measurements of the fields, on one thread
+ *                   and on numThreads, one query per cell
+ * @param sequentialStats Receives the measurements of compactDijkstra
+ * @return False if a field differs from that of compactDijkstra
+ */
+static bool compareFields(TBLoc source, const Grid<double>& world, int numThreads,
+                          double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                          AlgorithmStats fieldStats[2], AlgorithmStats& sequentialStats) {
+    const CompactGraph* graph = ensureCompactGraph(world, costFn);
+    int count = graph->numVertices();
+    SearchState state(count);
+    vector<bool> isTarget(count, true);
+    Clock::time_point sequentialStart = Clock::now();
+    compactDijkstra(*graph, state, graph->vertexId(source), isTarget, count);
+    sequentialStats.latencies.assign(count, millisecondsSince(sequentialStart) * 1000 / count);
+
+    bool isAgreed = true;
+    int threads[2] = { 1, numThreads };
+    for (int k = 0; k < 2; k++) {
+        Clock::time_point fieldStart = Clock::now();
+        Grid<double> field = distanceField(source, world, costFn, threads[k]);
+        fieldStats[k].latencies.assign(count, millisecondsSince(fieldStart) * 1000 / count);
+
+        for (int v = 0; v < count; v++) {
+            TBLoc loc = graph->location(v);
+            double cost = field.get(loc.row, loc.col);
+            if (cost != INFINITY) {
+                fieldStats[k].found++;
+                fieldStats[k].totalCost += cost;
+            }
+            if (!sameCost(cost, state.cost(v)))
+                isAgreed = false;
+        }
+    }
+
+    for (int v = 0; v < count; v++) {
+        if (state.cost(v) != INFINITY) {
+            sequentialStats.found++;
+            sequentialStats.totalCost += state.cost(v);
+        }
+    }
+    return isAgreed;
+}
+
+/**
+ * Answers the queries with shortestPaths on one thread and on the given number
+ * of threads, and checks that both find the same costs
+ * @param queries The (start, end) pairs to search for
+ * @param world The world, whose compact graph must already be cached
+ * @param numThreads The threads of the parallel batch; 0 for one per hardware thread
+ * @param costFn The cost function of the world
+ * @param heuristicFn The heuristic of the world
+ * @param batchStats Receives the measurements of the batches, on one thread and
+ *                   on numThreads
+ * @return False if some query has a different cost in the two batches
+ */
+static bool compareBatches(const vector<TBEdge>& queries, const Grid<double>& world, int numThreads,
+                           double costFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                           double heuristicFn(TBLoc from, TBLoc to, const Grid<double>& world),
+                           AlgorithmStats batchStats[2]) {
+    Vector<TBEdge> batch;
+    for (const TBEdge& query : queries)
+        batch.add(query);
+
+    Vector<PathResult> results[2];
+    int threads[2] = { 1, numThreads };
+    for (int k = 0; k < 2; k++) {
+        Clock::time_point batchStart = Clock::now();
+        results[k] = shortestPaths(batch, world, costFn, heuristicFn, threads[k]);
+        double batchUs = millisecondsSince(batchStart) * 1000;
+        batchStats[k].latencies.assign(batch.size(), batch.isEmpty() ? 0 : batchUs / batch.size());
+        for (const PathResult& result : results[k]) {
+            if (result.cost != INFINITY) {
+                batchStats[k].found++;
+                batchStats[k].totalCost += result.cost;
+            }
+        }
+    }
+
+    bool isAgreed = true;
+    for (int i = 0; i < batch.size(); i++) {
+        if (results[0][i].cost != results[1][i].cost)
+            isAgreed = false;
+    }
+    return isAgreed;
+}
+
+/**
+ * Prints the header of the report
+ * @param report The stream to print to
+ * @param csv If true, prints comma-separated values instead of a table
+ */
+static void printHeader(ostream& report, bool csv) {
+    if (csv) {
+        report << "world,algorithm,queries,found,mean_expanded,mean_cost,load_ms,model_ms,prepare_ms,"
+               << "p50_us,p90_us,p99_us,max_us,total_ms,queries_per_s,peak_mb" << endl;
+    }
+    else {
+        report << left << setw(22) << "world" << setw(10) << "algorithm" << right
+               << setw(8) << "queries" << setw(8) << "found" << setw(11) << "expanded" << setw(10) << "cost"
+               << setw(10) << "load ms" << setw(10) << "model ms" << setw(10) << "prep ms" << setw(10) << "p50 us" << setw(10) << "p90 us"
+               << setw(10) << "p99 us" << setw(10) << "max us" << setw(10) << "total ms" << setw(10) << "queries/s" << setw(9) << "peak MB" << endl;
+    }
+}
+
+/**
+ * Prints the measurements of one algorithm on one world
+ * @param report The stream to print to
+ * @param csv If true, prints comma-separated values instead of a table
+ * @param world The name of the world
+ * @param algorithm The name of the algorithm measured
+ * @param stats The measurements
+ * @param loadMs The time it took to read the world file
+ * @param modelMs The time it took to turn the world into a graph
+ */
+static void printStats(ostream& report, bool csv, const string& world, const string& algorithm,
+                       const AlgorithmStats& stats, double loadMs, double modelMs) {
+    int queries = stats.latencies.size();
+    double meanExpanded = queries == 0 ? 0 : (double) stats.expanded / queries;
+    double meanCost = stats.found == 0 ? 0 : stats.totalCost / stats.found;
+    double p50 = queries == 0 ? 0 : percentile(stats.latencies, 50);
+    double p90 = queries == 0 ? 0 : percentile(stats.latencies, 90);
+    double p99 = queries == 0 ? 0 : percentile(stats.latencies, 99);
+    double maximum = queries == 0 ? 0 : stats.latencies.back();
+    double totalMs = accumulate(stats.latencies.begin(), stats.latencies.end(), 0.0) / 1000;
+    double perSecond = totalMs == 0 ? 0 : queries / totalMs * 1000;
+
+    report << fixed;
+    if (csv) {
+        report << world << "," << algorithm << "," << queries << "," << stats.found << ","
+               << setprecision(1) << meanExpanded << "," << setprecision(4) << meanCost << ","
+               << setprecision(1) << loadMs << "," << modelMs << "," << stats.prepareMs << ","
+               << p50 << "," << p90 << "," << p99 << "," << maximum << "," << totalMs << "," << perSecond << "," << peakMemoryMB() << endl;
+    }
+    else {
+        report << left << setw(22) << world << setw(10) << algorithm << right
+               << setw(8) << queries << setw(8) << stats.found
+               << setprecision(1) << setw(11) << meanExpanded << setprecision(3) << setw(10) << meanCost
+               << setprecision(1) << setw(10) << loadMs << setw(10) << modelMs << setw(10) << stats.prepareMs
+               << setw(10) << p50 << setw(10) << p90 << setw(10) << p99 << setw(10) << maximum
+               << setw(10) << totalMs << setprecision(0) << setw(10) << perSecond << setw(9) << setprecision(1)
+               << peakMemoryMB() << endl;
+    }
+}
+
+/**
+ * Loads a world file and benchmarks the chosen algorithms on it
+ * @param filename The world file
+ * @param options The settings given on the command line
+ * @param report The stream to print the measurements to
+ * @return False if the world could not be loaded, or one of the checks of -grid,
+ *         -changes, -matrix, -field and -batch fails
+ */
+static bool benchmarkWorld(const string& filename, const Options& options, ostream& report) {
+    Grid<double> world;
+    WorldType worldType;
+    Clock::time_point loadStart = Clock::now();
+    if (!loadWorldFile(filename, world, worldType)) {
+        cerr << filename << " is not a valid world file." << endl;
+        return false;
+    }
+    double loadMs = millisecondsSince(loadStart);
+
+    string name = filename.substr(filename.find_last_of("/\\") + 1);
+    bool isTerrain = worldType == TERRAIN_WORLD;
+    auto costFn = isTerrain ? terrainCost : mazeCost;
+    auto heuristicFn = isTerrain ? terrainHeuristic : mazeHeuristic;
+
+    vector<AlgorithmType> algorithms = options.algorithms;
+    if (algorithms.empty()) {
+        for (AlgorithmType algorithm : ALL_ALGORITHMS) {
+            if (!isTerrain || (algorithm != DFS && algorithm != BFS))
+                algorithms.push_back(algorithm);
+        }
+    }
+
+    vector<TBEdge> queries = makeQueries(world, worldType, options.numQueries, options.seed);
+
+    Clock::time_point modelStart = Clock::now();
+    ensureWorldCache(world, costFn);
+    ensureCompactGraph(world, costFn);
+    double modelMs = millisecondsSince(modelStart);
+
+    for (AlgorithmType algorithm : algorithms) {
+        AlgorithmStats stats = runAlgorithm(algorithm, queries, world, costFn, heuristicFn);
+        printStats(report, options.csv, name, algorithmName(algorithm), stats, loadMs, modelMs);
+    }
+
+    bool isAgreed = true;
+    if (options.compareGrid) {
+        AlgorithmStats compactStats;
+        AlgorithmStats gridStats;
+        isAgreed = compareGridSearch(queries, world, costFn, heuristicFn, compactStats, gridStats);
+        printStats(report, options.csv, name, "compact", compactStats, loadMs, modelMs);
+        printStats(report, options.csv, name, "grid", gridStats, loadMs, modelMs);
+        if (!isAgreed)
+            cerr << name << ": compactAStar and gridAStar found paths of different cost." << endl;
+    }
+
+    if (options.numChanges > 0) {
+        // The changed worlds are of no use to later runs, so none are written to the cache directory
+        AlgorithmStats repairStats;
+        setWorldCacheDirectory("");
+        bool isRepaired = runRepairs(queries, world, options.numChanges, options.seed, costFn, heuristicFn, repairStats);
+        setWorldCacheDirectory(options.cacheDirectory);
+        printStats(report, options.csv, name, "repair", repairStats, loadMs, modelMs);
+        if (!isRepaired)
+            cerr << name << ": D* Lite and compactAStar found paths of different cost after changes." << endl;
+        isAgreed = isAgreed && isRepaired;
+    }
+
+    if (options.matrixSize > 0) {
+        Vector<TBLoc> locations;
+        for (const TBEdge& pair : makeQueries(world, worldType, options.matrixSize, options.seed + 1))
+            locations.add(pair.start);
+        AlgorithmStats matrixStats;
+        AlgorithmStats pairStats;
+        bool isMatched = compareMatrix(locations, world, options.numThreads, costFn, heuristicFn, matrixStats, pairStats);
+        printStats(report, options.csv, name, "matrix", matrixStats, loadMs, modelMs);
+        printStats(report, options.csv, name, "pairwise", pairStats, loadMs, modelMs);
+        if (!isMatched)
+            cerr << name << ": distanceMatrix and compactAStar found different costs." << endl;
+        isAgreed = isAgreed && isMatched;
+    }
+
+    int numThreads = options.numThreads > 0 ? options.numThreads : max(1u, thread::hardware_concurrency());
+    if (options.compareField && !queries.empty()) {
+        AlgorithmStats fieldStats[2];
+        AlgorithmStats sequentialStats;
+        bool isMatched = compareFields(queries[0].start, world, numThreads, costFn, fieldStats, sequentialStats);
+        printStats(report, options.csv, name, "seqfield", sequentialStats, loadMs, modelMs);
+        printStats(report, options.csv, name, "field1", fieldStats[0], loadMs, modelMs);
+        printStats(report, options.csv, name, "field" + to_string(numThreads), fieldStats[1], loadMs, modelMs);
+        if (!isMatched)
+            cerr << name << ": distanceField and compactDijkstra found different costs." << endl;
+        isAgreed = isAgreed && isMatched;
+    }
+
+    if (options.compareBatch) {
+        AlgorithmStats batchStats[2];
+        bool isMatched = compareBatches(queries, world, numThreads, costFn, heuristicFn, batchStats);
+        printStats(report, options.csv, name, "batch1", batchStats[0], loadMs, modelMs);
+        printStats(report, options.csv, name, "batch" + to_string(numThreads), batchStats[1], loadMs, modelMs);
+        if (!isMatched)
+            cerr << name << ": shortestPaths found different costs on 1 and " << numThreads << " threads." << endl;
+        isAgreed = isAgreed && isMatched;
+    }
+
+    // Measure every world from a cold cache, and hold only one in memory at a time
+    flushWorldCache();
+    return isAgreed;
+}
+
+/**
+ * Reads a whole string as a non-negative integer
+ * @param text The string
+ * @param value Receives the integer
+ * @return False if the string is not a non-negative integer
+ */
+static bool readCount(const string& text, int& value) {
+    istringstream stream(text);
+    stream >> value;
+    return !stream.fail() && stream.eof() && value >= 0;
+}
+
+/**
+ * Reads the command line
+ * @param argc The number of arguments
+ * @param argv The arguments
+ * @param options Receives the settings
+ * @return False if the command line is not valid
+ */
+static bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-q" && hasValue) {
+            if (!readCount(argv[++i], options.numQueries))
+                return false;
+        }
+        else if (arg == "-s" && hasValue) {
+            int seed;
+            if (!readCount(argv[++i], seed))
+                return false;
+            options.seed = seed;
+        }
+        else if (arg == "-a" && hasValue) {
+            istringstream names(argv[++i]);
+            string name;
+            while (getline(names, name, ',')) {
+                int index = find(ALGORITHM_NAMES, ALGORITHM_NAMES + NUM_ALGORITHMS, name) - ALGORITHM_NAMES;
+                if (index == NUM_ALGORITHMS) {
+                    cerr << "Unknown algorithm " << name << endl;
+                    return false;
+                }
+                options.algorithms.push_back(ALL_ALGORITHMS[index]);
+            }
+        }
+        else if (arg == "-cache" && hasValue)
+            options.cacheDirectory = argv[++i];
+        else if (arg == "-j" && hasValue) {
+            if (!readCount(argv[++i], options.numThreads))
+                return false;
+        }
+        else if (arg == "-matrix" && hasValue) {
+            if (!readCount(argv[++i], options.matrixSize))
+                return false;
+        }
+        else if (arg == "-batch")
+            options.compareBatch = true;
+        else if (arg == "-field")
+            options.compareField = true;
+        else if (arg == "-grid")
+            options.compareGrid = true;
+        else if (arg == "-changes" && hasValue) {
+            if (!readCount(argv[++i], options.numChanges))
+                return false;
+        }
+        else if (arg == "-csv")
+            options.csv = true;
+        else if (!arg.empty() && arg[0] != '-')
+            options.worldFiles.push_back(arg);
+        else
+            return false;
+    }
+    return !options.worldFiles.empty();
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "Usage: " << argv[0] << " [-q queries] [-s seed] [-a algorithm,...] [-cache dir] [-j threads] [-grid]"
+             << " [-changes cells] [-matrix locations] [-field] [-batch] [-csv] world..." << endl;
+        cerr << "Algorithms: dfs, bfs, dijkstra, astar, alt, ch, dstar, hpa" << endl;
+        return 1;
+    }
+
+    // The searches narrate every query on cout, so the report gets its own stream
+    ostream report(cout.rdbuf());
+    cout.rdbuf(nullptr);
+
+    setWorldCacheDirectory(options.cacheDirectory);
+    setSearchInstrumentation(COUNT_STEPS);
+    printHeader(report, options.csv);
+    bool allLoaded = true;
+    for (const string& filename : options.worldFiles) {
+        try {
+            allLoaded = benchmarkWorld(filename, options, report) && allLoaded;
+        } catch (const ErrorException& ex) {
+            cerr << filename << ": " << ex.getMessage() << endl;
+            allLoaded = false;
+        }
+    }
+    return allLoaded ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+/**
+ * Converts text world files into the binary world format, which loads much
+ * faster (see writeBinaryWorldFile in worldfile.h).  Each file name.txt is
+ * written as name.tbw next to it, after being validated like any loaded world.
+ * Build it from src/ together with worldfile.cpp, plus error and strlib from
+ * the Stanford library, and put src/ and lib/StanfordCPPLib on the include path.
+ *
+ * Usage: worldconvert world...
+ * @file worldconvert.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "grid.h"
+#include "worldfile.h"
+#include "error.h"
+#undef main   // error.h renames main for the GUI, but this program has no GUI
+
+using namespace std;
+
+/**
+ * Names the binary file that a world file is converted to
+ * @param filename The world file
+ * @return The file name with its extension replaced by .tbw
+ */
+static string binaryName(const string& filename) {
+    size_t dot = filename.find_last_of('.');
+    size_t slash = filename.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return filename + ".tbw";
+    return filename.substr(0, dot) + ".tbw";
+}
+
+/**
+ * Converts one world file
+ * @param filename The world file to read
+ * @return False if it could not be read or the binary file could not be written
+ */
+static bool convertWorld(const string& filename) {
+    Grid<double> world;
+    WorldType worldType;
+    if (!loadWorldFile(filename, world, worldType)) {
+        cerr << filename << " is not a valid world file." << endl;
+        return false;
+    }
+
+    string output = binaryName(filename);
+    if (output == filename) {
+        cerr << filename << " is already a binary world file." << endl;
+        return false;
+    }
+    ofstream file(output.c_str(), ios::binary);
+    if (file.fail() || !writeBinaryWorldFile(file, world, worldType)) {
+        cerr << "Unable to write " << output << endl;
+        return false;
+    }
+    cout << filename << " -> " << output << " (" << world.numRows() << "x" << world.numCols()
+         << (worldType == MAZE_WORLD ? " maze" : " terrain") << ")" << endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: worldconvert world..." << endl;
+        return 2;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!convertWorld(argv[i]))
+            failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
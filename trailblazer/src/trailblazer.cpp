@@ -6,6 +6,7 @@
 
 #include "costs.h"
 #include "trailblazer.h"
+#include <algorithm>
 #include <stack>
 #include <queue>
 
@@ -17,29 +18,33 @@ using namespace std;
  * Find a path from one vertex to another via the dfs algorithm
  * @param graph The graph to search on
  * @param start The vertex to find the path from
- * @param end The vertex to find the path to
- * @return A vertex vector representing the path
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ * @param observer Told about each step of the search (see SearchObserver.h)
  */
-vector<Node *> depthFirstSearch(BasicGraph& graph, Vertex* start, Vertex* end) {
-    vector<Vertex*> path;
-
-    // Reset all edges & vertices
-    graph.resetData();
+template <typename Observer>
+void searchDepthFirst(BasicGraph& graph, Vertex* start, Vertex* end, Observer& observer) {
+    // Start a new search; each vertex is reset when first refreshed
+    graph.beginSearch();
+    start->refresh();
+    end->refresh();
 
     // Find end vertex from start vertex
     stack<Vertex*> vertexStack;
     vertexStack.push(start);
-    start->setColor(YELLOW);
+    observer.pushed(start);
 
     bool endIsFound = false;
     while(!vertexStack.empty() && !endIsFound) {
         Vertex* current = vertexStack.top();
         vertexStack.pop();
+        observer.popped(current);
 
         // Visit each non-visited neighbor
         bool atDeadEnd = true;
         for(Edge* edge : current->arcs) {
             Vertex* next = edge->finish;
+            next->refresh();
 
             if (!next->visited) {
                 next->previous = current;
@@ -47,211 +52,310 @@ vector<Node *> depthFirstSearch(BasicGraph& graph, Vertex* start, Vertex* end) {
 
                 if (next == end) {
                     endIsFound = true; // Stops the searching
-                    next->setColor(GREEN);
+                    observer.reached(next);
                 }
                 else {
                     vertexStack.push(next);
-                    next->setColor(YELLOW);
+                    observer.pushed(next);
                 }
             }
         }
 
         current->visited = true;
         if (atDeadEnd)
-            current->setColor(GRAY);
+            observer.abandoned(current);
         else
-            current->setColor(GREEN);
-    }
-
-    // Add vertices to path vector
-    Vertex* current = end;
-    while(current != nullptr) {
-        path.insert(path.begin(), current);
-        current = current->previous;
+            observer.settled(current);
     }
-
-    return path;
 }
 
 /**
  * Find a path from one vertex to another via the bfs algorithm
  * @param graph The graph to search on
  * @param start The vertex to find the path from
- * @param end The vertex to find the path to
- * @return A vertex vector representing the path
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ * @param observer Told about each step of the search (see SearchObserver.h)
  */
-vector<Node *> breadthFirstSearch(BasicGraph& graph, Vertex* start, Vertex* end) {
-    vector<Vertex*> path;
-
-    // Reset all edges & vertices
-    graph.resetData();
+template <typename Observer>
+void searchBreadthFirst(BasicGraph& graph, Vertex* start, Vertex* end, Observer& observer) {
+    // Start a new search; each vertex is reset when first refreshed
+    graph.beginSearch();
+    start->refresh();
+    end->refresh();
 
     // Find end vertex from start vertex
     queue<Vertex*> vertexQueue;
     vertexQueue.push(start);
-    start->setColor(YELLOW);
+    observer.pushed(start);
 
     bool endIsFound = false;
     while(!vertexQueue.empty() && !endIsFound) {
         Vertex* current = vertexQueue.front();
         vertexQueue.pop();
+        observer.popped(current);
 
         // Visit each non-visited neighbor
         for(Edge* edge : current->arcs) {
             Vertex* next = edge->finish;
+            next->refresh();
 
             if (!next->visited) {
                 next->previous = current;
 
                 if (next == end) {
                     endIsFound = true; // Stops the searching
-                    next->setColor(GREEN);
+                    observer.reached(next);
                 }
                 else {
                     vertexQueue.push(next);
-                    next->setColor(YELLOW);
+                    observer.pushed(next);
                 }
             }
         }
 
         current->visited = true;
-        current->setColor(GREEN);
-    }
-
-    // Add vertices to path vector
-    Vertex* current = end;
-    while(current != nullptr) {
-        path.insert(path.begin(), current);
-        current = current->previous;
+        observer.settled(current);
     }
-
-    return path;
 }
 
 /**
  * Find a path from one vertex to another via the dijkstras algorithm
  * @param graph The graph to search on
  * @param start The vertex to find the path from
- * @param end The vertex to find the path to
- * @return A vertex vector representing the path
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ * @param observer Told about each step of the search (see SearchObserver.h)
  */
-vector<Node *> dijkstrasAlgorithm(BasicGraph& graph, Vertex* start, Vertex* end) {
-    vector<Vertex*> path;
-
-    // Reset all edges & vertices
-    graph.resetData();
-    for(Vertex* vertex : graph.getVertexSet())
-        vertex->cost = INFINITY;
+template <typename Observer>
+void searchDijkstra(BasicGraph& graph, Vertex* start, Vertex* end, Observer& observer) {
+    // Start a new search; each vertex is reset to an infinite cost when first refreshed
+    graph.beginSearch(INFINITY);
+    start->refresh();
+    end->refresh();
 
     // Find end vertex from start vertex
     PriorityQueue<Vertex*> vertexQueue;
     vertexQueue.enqueue(start, 0);
-    start->setColor(YELLOW);
+    observer.pushed(start);
     start->cost = 0;
 
     bool endIsFound = false;
     while(vertexQueue.size() > 0 && !endIsFound) {
         Vertex* current = vertexQueue.dequeue();
+        observer.popped(current);
 
         // Visit each neighbor
         for(Edge* edge : current->arcs) {
             Vertex* next = edge->finish;
+            next->refresh();
 
-            // Only interact with neighbor if its current cost is greater than its potential cost
-            if (next->cost > current->cost + edge->cost)  {
+            // Only interact with neighbor if it is not yet dequeued and its current cost is greater than its potential cost
+            if (!next->visited && next->cost > current->cost + edge->cost)  {
+                bool isEnqueued = next->cost != INFINITY; // A vertex is enqueued as soon as it gets a finite cost
                 next->cost = current->cost + edge->cost;
                 next->previous = current;
 
                 if (next == end) {
                     endIsFound = true; // Stops the searching
-                    next->setColor(GREEN);
+                    observer.reached(next);
                 }
-                else if (!next->visited) {
+                else if (!isEnqueued) {
                     vertexQueue.enqueue(next, next->cost);
-                    next->setColor(YELLOW);
-                    next->visited = true; // Marks as visited immediately to avoid enqueuing the same vertex twice (AKA enter this else-if statement)
+                    observer.pushed(next);
                 }
                 else {
                     vertexQueue.changePriority(next, next->cost);
-                    next->setColor(YELLOW);
+                    observer.decreased(next);
                 }
             }
         }
 
         current->visited = true;
-        current->setColor(GREEN);
+        observer.settled(current);
     }
-
-    // Add vertices to path vector
-    Vertex* current = end;
-    while(current != nullptr) {
-        path.insert(path.begin(), current);
-        current = current->previous;
-    }
-
-    return path;
 }
 
 /**
  * Find a path from one vertex to another via the a* algorithm
  * @param graph The graph to search on
  * @param start The vertex to find the path from
- * @param end The vertex to find the path to
- * @return A vertex vector representing the path
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ * @param observer Told about each step of the search (see SearchObserver.h)
  */
-vector<Node *> aStar(BasicGraph& graph, Vertex* start, Vertex* end) {
-    vector<Vertex*> path;
-
-    // Reset all edges & vertices
-    graph.resetData();
-    for(Vertex* vertex : graph.getVertexSet())
-        vertex->cost = INFINITY;
+template <typename Observer>
+void searchAStar(BasicGraph& graph, Vertex* start, Vertex* end, Observer& observer) {
+    // Start a new search; each vertex is reset to an infinite cost when first refreshed
+    graph.beginSearch(INFINITY);
+    start->refresh();
+    end->refresh();
 
     // Find end vertex from start vertex
     PriorityQueue<Vertex*> vertexQueue;
     vertexQueue.enqueue(start, 0);
-    start->setColor(YELLOW);
+    observer.pushed(start);
     start->cost = 0;
 
     bool endIsFound = false;
     while(vertexQueue.size() > 0 && !endIsFound) {
         Vertex* current = vertexQueue.dequeue();
+        observer.popped(current);
 
         // Visit each neighbor
         for(Edge* edge : current->arcs) {
             Vertex* next = edge->finish;
+            next->refresh();
 
-            // Only interact with neighbor if its current cost is greater than its potential cost
-            if (next->cost > current->cost + edge->cost)  {
+            // Only interact with neighbor if it is not yet dequeued and its current cost is greater than its potential cost
+            if (!next->visited && next->cost > current->cost + edge->cost)  {
+                bool isEnqueued = next->cost != INFINITY; // A vertex is enqueued as soon as it gets a finite cost
                 next->cost = current->cost + edge->cost;
                 next->previous = current;
 
                 if (next == end) {
                     endIsFound = true; // Stops the searching
-                    next->setColor(GREEN);
+                    observer.reached(next);
                 }
-                else if (!next->visited) {
+                else if (!isEnqueued) {
                     vertexQueue.enqueue(next, next->cost + next->heuristic(end)); // Priority is potential cost of path including this vertex
-                    next->setColor(YELLOW);
-                    next->visited = true; // Marks as visited immediately to avoid enqueuing the same vertex twice (AKA enter this else-if statement)
+                    observer.pushed(next);
                 }
                 else {
                     vertexQueue.changePriority(next, next->cost + next->heuristic(end)); // Priority is potential cost of path including this vertex
-                    next->setColor(YELLOW);
+                    observer.decreased(next);
                 }
             }
         }
 
         current->visited = true;
-        current->setColor(GREEN);
+        observer.settled(current);
     }
+}
 
-    // Add vertices to path vector
-    Vertex* current = end;
-    while(current != nullptr) {
-        path.insert(path.begin(), current);
-        current = current->previous;
-    }
+// The observers the searches are compiled for
+template void searchDepthFirst(BasicGraph&, Vertex*, Vertex*, NullObserver&);
+template void searchDepthFirst(BasicGraph&, Vertex*, Vertex*, ColorObserver&);
+template void searchDepthFirst(BasicGraph&, Vertex*, Vertex*, CountingObserver&);
+template void searchBreadthFirst(BasicGraph&, Vertex*, Vertex*, NullObserver&);
+template void searchBreadthFirst(BasicGraph&, Vertex*, Vertex*, ColorObserver&);
+template void searchBreadthFirst(BasicGraph&, Vertex*, Vertex*, CountingObserver&);
+template void searchDijkstra(BasicGraph&, Vertex*, Vertex*, NullObserver&);
+template void searchDijkstra(BasicGraph&, Vertex*, Vertex*, ColorObserver&);
+template void searchDijkstra(BasicGraph&, Vertex*, Vertex*, CountingObserver&);
+template void searchAStar(BasicGraph&, Vertex*, Vertex*, NullObserver&);
+template void searchAStar(BasicGraph&, Vertex*, Vertex*, ColorObserver&);
+template void searchAStar(BasicGraph&, Vertex*, Vertex*, CountingObserver&);
+
+/**
+ * Find a path from one vertex to another via the dfs algorithm, colouring the
+ * vertices for the GUI as it goes
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ */
+void searchDepthFirst(BasicGraph& graph, Vertex* start, Vertex* end) {
+    ColorObserver observer;
+    searchDepthFirst(graph, start, end, observer);
+}
+
+/**
+ * Find a path from one vertex to another via the bfs algorithm, colouring the
+ * vertices for the GUI as it goes
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ */
+void searchBreadthFirst(BasicGraph& graph, Vertex* start, Vertex* end) {
+    ColorObserver observer;
+    searchBreadthFirst(graph, start, end, observer);
+}
+
+/**
+ * Find a path from one vertex to another via the dijkstras algorithm, colouring
+ * the vertices for the GUI as it goes
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ */
+void searchDijkstra(BasicGraph& graph, Vertex* start, Vertex* end) {
+    ColorObserver observer;
+    searchDijkstra(graph, start, end, observer);
+}
+
+/**
+ * Find a path from one vertex to another via the a* algorithm, colouring the
+ * vertices for the GUI as it goes
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to; the path is left in the previous
+ *            pointers, ready for extractPath
+ */
+void searchAStar(BasicGraph& graph, Vertex* start, Vertex* end) {
+    ColorObserver observer;
+    searchAStar(graph, start, end, observer);
+}
 
+/**
+ * Follows the previous pointers back from a vertex to build the path leading to it
+ * @param end The last vertex of the path
+ * @return A vertex vector representing the path
+ */
+static vector<Vertex*> pathTo(Vertex* end) {
+    vector<Vertex*> path;
+    for (Vertex* current = end; current != nullptr; current = current->previous)
+        path.push_back(current);
+    reverse(path.begin(), path.end());
     return path;
 }
+
+/**
+ * Find a path from one vertex to another via the dfs algorithm
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to
+ * @return A vertex vector representing the path
+ */
+vector<Node *> depthFirstSearch(BasicGraph& graph, Vertex* start, Vertex* end) {
+    searchDepthFirst(graph, start, end);
+    return pathTo(end);
+}
+
+/**
+ * Find a path from one vertex to another via the bfs algorithm
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to
+ * @return A vertex vector representing the path
+ */
+vector<Node *> breadthFirstSearch(BasicGraph& graph, Vertex* start, Vertex* end) {
+    searchBreadthFirst(graph, start, end);
+    return pathTo(end);
+}
+
+/**
+ * Find a path from one vertex to another via the dijkstras algorithm
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to
+ * @return A vertex vector representing the path
+ */
+vector<Node *> dijkstrasAlgorithm(BasicGraph& graph, Vertex* start, Vertex* end) {
+    searchDijkstra(graph, start, end);
+    return pathTo(end);
+}
+
+/**
+ * Find a path from one vertex to another via the a* algorithm
+ * @param graph The graph to search on
+ * @param start The vertex to find the path from
+ * @param end The vertex to find the path to
+ * @return A vertex vector representing the path
+ */
+vector<Node *> aStar(BasicGraph& graph, Vertex* start, Vertex* end) {
+    searchAStar(graph, start, end);
+    return pathTo(end);
+}
@@ -14,10 +14,35 @@
 
 #include <vector>
 #include "BasicGraph.h"
+#include "SearchObserver.h"
 
 vector<Node*> depthFirstSearch(BasicGraph& graph, Node* start, Node* end);
 vector<Node*> breadthFirstSearch(BasicGraph& graph, Node* start, Node* end);
 vector<Node*> dijkstrasAlgorithm(BasicGraph& graph, Node* start, Node* end);
 vector<Node*> aStar(BasicGraph& graph, Node* start, Node* end);
 
+/*
+ * The same searches, leaving the path to end in the previous pointers of the
+ * vertices instead of building it, so that the caller can extract it into a
+ * buffer of its own with extractPath (see adapter.h).
+ */
+void searchDepthFirst(BasicGraph& graph, Node* start, Node* end);
+void searchBreadthFirst(BasicGraph& graph, Node* start, Node* end);
+void searchDijkstra(BasicGraph& graph, Node* start, Node* end);
+void searchAStar(BasicGraph& graph, Node* start, Node* end);
+
+/*
+ * The same searches again, reporting each step to the given observer instead
+ * of colouring the vertices; the ones above use a ColorObserver.  They are
+ * compiled for NullObserver, ColorObserver and CountingObserver.
+ */
+template <typename Observer>
+void searchDepthFirst(BasicGraph& graph, Node* start, Node* end, Observer& observer);
+template <typename Observer>
+void searchBreadthFirst(BasicGraph& graph, Node* start, Node* end, Observer& observer);
+template <typename Observer>
+void searchDijkstra(BasicGraph& graph, Node* start, Node* end, Observer& observer);
+template <typename Observer>
+void searchAStar(BasicGraph& graph, Node* start, Node* end, Observer& observer);
+
 #endif
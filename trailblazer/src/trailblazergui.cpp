@@ -38,6 +38,7 @@
 #include "costs.h"
 #include "trailblazer.h"
 #include "trailblazergui.h"
+#include "worldfile.h"
 using namespace std;
 
 // internal constants
@@ -67,13 +68,6 @@ const int kMargin = 5;
 const int kWidthAdjustment  =  0;
 const int kHeightAdjustment = 75;
 
-/*
- * Maximum number of rows or columns we allow in a world.    This is mostly a
- * safety feature to prevent an OOM on a malformed input file.
- */
-const int kMaxRows = 400;
-const int kMaxCols = 400;
-
 /*
  * Constants controlling the number of rows/cols in the different sizes of
  * worlds.  The indices into these arrays are controlled by the enumerated
@@ -132,7 +126,6 @@ static Set<string> getFiles(string substr);
 static void intro();
 static bool loadGUIState();
 static void locToCoord(TBLoc loc, double& x, double& y);
-static bool readWorldFile(ifstream& input, Grid<double>& world, WorldType& worldType);
 static bool regenerateWorld(Grid<double>& world, WorldType& worldType);
 static bool registerClick(Grid<double>& world, double x, double y, WorldType worldType);
 static void removeAndDelete(GObject* object);
@@ -251,6 +244,10 @@ void initializeGUI() {
     gAlgorithmList->addItem("Breadth-first Search");
     gAlgorithmList->addItem("Dijkstra's Algorithm");
     gAlgorithmList->addItem("A* Search");
+    gAlgorithmList->addItem("A* Search (landmarks)");
+    gAlgorithmList->addItem("Contraction Hierarchy");
+    gAlgorithmList->addItem("D* Lite (incremental)");
+    gAlgorithmList->addItem("HPA* (clusters)");
     gWindow->addToRegion(gAlgorithmList, "NORTH");
 
     gWindow->addToRegion(new GLabel("Delay:"), "NORTH");
@@ -503,6 +500,14 @@ static AlgorithmType getAlgorithmType() {
         return DIJKSTRA;
     } else if (algorithmLabel == "A* Search") {
         return A_STAR;
+    } else if (algorithmLabel == "A* Search (landmarks)") {
+        return ALT;
+    } else if (algorithmLabel == "Contraction Hierarchy") {
+        return CONTRACTION_HIERARCHY;
+    } else if (algorithmLabel == "D* Lite (incremental)") {
+        return D_STAR_LITE;
+    } else if (algorithmLabel == "HPA* (clusters)") {
+        return HPA_STAR;
     } else {
         error("Invalid algorithm provided.");
         return DIJKSTRA;
@@ -520,7 +525,7 @@ static Set<string> getFiles(string substr) {
     Set<string> result;
     foreach (string file in files) {
         string fileLC = toLowerCase(file);
-        if (startsWith(fileLC, substr) && endsWith(fileLC, ".txt")) {
+        if (startsWith(fileLC, substr) && (endsWith(fileLC, ".txt") || endsWith(fileLC, ".tbw"))) {
             result.add(file);
         }
     }
@@ -609,81 +614,6 @@ static void locToCoord(TBLoc loc, double& x, double& y) {
     y = loc.row * gPixelsPerHeight + kMargin;
 }
 
-/*
- * Tries to read a world file from the specified stream.  On success, returns
- * true and updates the input parameters to mark the type of the world and
- * the world contents.  On failure, returns false, but may still modify the
- * input parameters.
- */
-static bool readWorldFile(ifstream& input, Grid<double>& world, WorldType& worldType) {
-    try {
-        // Enable exceptions on the stream so that we can handle errors using try-
-        // catch rather than continuously testing everything.
-        input.exceptions(ios::failbit | ios::badbit);
-
-        // The file line of the file identifies the type, which should be either
-        // "terrain" or "maze."
-        string type;
-        input >> type;
-
-        if (type == "terrain") {
-            worldType = TERRAIN_WORLD;
-        } else if (type == "maze") {
-            worldType = MAZE_WORLD;
-        } else {
-            cerr << "world file does not contain type (terrain/maze) as first line." << endl;
-            return false;
-        }
-
-        // Read the size of the world.
-        int numRows, numCols;
-        input >> numRows >> numCols;
-
-        if (numRows <= 0 || numCols <= 0 ||
-                numRows >= kMaxRows || numRows >= kMaxCols) {
-            cerr << "world file contains invalid number of rows/cols: "
-                 << numRows << "," << numCols << endl;
-            return false;
-        }
-
-        world.resize(numRows, numCols);
-
-        for (int row = 0; row < numRows; row++) {
-            for (int col = 0; col < numCols; col++) {
-                double value;
-                input >> value;
-                if (input.fail()) {
-                    cerr << "Illegal input file format; row #" << (row+1)
-                         << "does not contain " << numCols << " valid numbers" << endl;
-                    return false;
-                }
-
-                // Validate the input based on the type of world.
-                if (worldType == MAZE_WORLD) {
-                    if (value != kMazeWall && value != kMazeFloor) {
-                        cerr << "world file contains invalid square value of " << value
-                             << ", must be " << kMazeFloor << " or " << kMazeWall << endl;
-                        return false;
-                    }
-                } else {  // worldType == TERRAIN_WORLD
-                    if (value < 0.0 || value > 1.0) {
-                        cerr << "world file contains invalid terrain value of " << value
-                             << ", must be 0.0 - 1.0" << endl;
-                        return false;
-                    }
-                }
-                world[row][col] = value;
-            }
-        }
-
-        return true;
-    } catch (...) {
-        // Something went wrong, so report an error.
-        cerr << "exception thrown while reading world file" << endl;
-        return false;
-    }
-}
-
 /*
  * Generates a new world based on the user's preferences.
  */
@@ -735,11 +665,12 @@ static bool regenerateWorld(Grid<double>& world, WorldType& worldType) {
             error(string("Unable to open input file ") + worldFile);
             return false;
         }
+        input.close();
 
-        // Try reading in the world file.  If we can't, report an error.
+        // Try reading in the world file, text or binary.  If we can't, report an error.
         Grid<double> newWorld;
         WorldType newWorldType;
-        if (!readWorldFile(input, newWorld, newWorldType)) {
+        if (!loadWorldFile(worldFile, newWorld, newWorldType)) {
             cerr << worldFile << " is not a valid world file." << endl;
             return false;
         }
@@ -1015,10 +946,10 @@ static void uncolorSquares() {
 
 /*
  * Called anytime the current world is changed, so that we can update the
- * cache of Grid -> Graph.
+ * cache of Grid -> Graph.  The cache is keyed by the contents of the world, so
+ * reloading a world that is still cached does not rebuild anything.
  */
 static void worldUpdated(Grid<double>& world, WorldType worldType) {
-    flushWorldCache();
     if (worldType == TERRAIN_WORLD) {
         ensureWorldCache(world, terrainCost);
     } else if (worldType == MAZE_WORLD) {
@@ -17,15 +17,7 @@
 #include "gevents.h"
 #include "grid.h"
 #include "types.h"
-
-/*
- * An enumerated type tracking what type of world is currently selected so that
- * we can determine which clicked locations are legal.
- */
-enum WorldType {
-    TERRAIN_WORLD,
-    MAZE_WORLD
-};
+#include "worldfile.h"
 
 /*
  * An enumerated type representing how large the world is, categorized as one
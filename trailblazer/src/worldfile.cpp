@@ -0,0 +1,274 @@
+/*
+ * TDDD86 Trailblazer
+ * This file implements the readers and writer for the maze and terrain world files.
+ * See worldfile.h for documentation of each public function.
+ *
+ * Author: Marty Stepp, Keith Schwarz, et al
+ * Slight modifications by Tommy Farnqvist
+ */
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "costs.h"
+#include "worldfile.h"
+using namespace std;
+
+// size of the header of a binary world file, in bytes
+static const size_t kBinaryHeaderSize = 20;
+
+// function prototype declarations
+static void encodeUint32(unsigned int value, char* bytes);
+static unsigned int decodeUint32(const unsigned char* bytes);
+static bool decodeBinaryWorld(const unsigned char* data, size_t size,
+                              Grid<double>& world, WorldType& worldType);
+
+/*
+ * (public function)
+ * Reads a world file, validating its type, size and cell values.
+ */
+bool readWorldFile(istream& input, Grid<double>& world, WorldType& worldType) {
+    try {
+        // Enable exceptions on the stream so that we can handle errors using try-
+        // catch rather than continuously testing everything.
+        input.exceptions(ios::failbit | ios::badbit);
+
+        // The file line of the file identifies the type, which should be either
+        // "terrain" or "maze."
+        string type;
+        input >> type;
+
+        if (type == "terrain") {
+            worldType = TERRAIN_WORLD;
+        } else if (type == "maze") {
+            worldType = MAZE_WORLD;
+        } else {
+            cerr << "world file does not contain type (terrain/maze) as first line." << endl;
+            return false;
+        }
+
+        // Read the size of the world.
+        int numRows, numCols;
+        input >> numRows >> numCols;
+
+        if (numRows <= 0 || numCols <= 0 ||
+                numRows >= kMaxRows || numRows >= kMaxCols) {
+            cerr << "world file contains invalid number of rows/cols: "
+                 << numRows << "," << numCols << endl;
+            return false;
+        }
+
+        world.resize(numRows, numCols);
+
+        for (int row = 0; row < numRows; row++) {
+            for (int col = 0; col < numCols; col++) {
+                double value;
+                input >> value;
+                if (input.fail()) {
+                    cerr << "Illegal input file format; row #" << (row+1)
+                         << "does not contain " << numCols << " valid numbers" << endl;
+                    return false;
+                }
+
+                // Validate the input based on the type of world.
+                if (worldType == MAZE_WORLD) {
+                    if (value != kMazeWall && value != kMazeFloor) {
+                        cerr << "world file contains invalid square value of " << value
+                             << ", must be " << kMazeFloor << " or " << kMazeWall << endl;
+                        return false;
+                    }
+                } else {  // worldType == TERRAIN_WORLD
+                    if (value < 0.0 || value > 1.0) {
+                        cerr << "world file contains invalid terrain value of " << value
+                             << ", must be 0.0 - 1.0" << endl;
+                        return false;
+                    }
+                }
+                world[row][col] = value;
+            }
+        }
+
+        return true;
+    } catch (...) {
+        // Something went wrong, so report an error.
+        cerr << "exception thrown while reading world file" << endl;
+        return false;
+    }
+}
+
+/*
+ * (public function)
+ * Writes the header and then the cells row by row, one row per write call.
+ */
+bool writeBinaryWorldFile(ostream& output, const Grid<double>& world, WorldType worldType) {
+    char header[kBinaryHeaderSize];
+    memcpy(header, kBinaryWorldMagic, sizeof(kBinaryWorldMagic));
+    encodeUint32(kBinaryWorldVersion, header + 4);
+    encodeUint32(worldType == MAZE_WORLD ? 1 : 0, header + 8);
+    encodeUint32(world.numRows(), header + 12);
+    encodeUint32(world.numCols(), header + 16);
+    output.write(header, kBinaryHeaderSize);
+
+    int cellSize = worldType == MAZE_WORLD ? 1 : 4;
+    vector<char> row(world.numCols() * cellSize);
+    for (int r = 0; r < world.numRows(); r++) {
+        for (int c = 0; c < world.numCols(); c++) {
+            if (worldType == MAZE_WORLD) {
+                row[c] = world.get(r, c) == kMazeFloor ? 1 : 0;
+            } else {
+                float value = (float) world.get(r, c);
+                unsigned int bits;
+                memcpy(&bits, &value, sizeof(bits));
+                encodeUint32(bits, &row[c * 4]);
+            }
+        }
+        output.write(&row[0], row.size());
+    }
+    return !output.fail();
+}
+
+/*
+ * (public function)
+ * Looks at the first bytes of the file to tell the two formats apart.  Binary
+ * files are mapped into memory and decoded in place rather than read into a
+ * buffer first.
+ */
+bool loadWorldFile(const string& filename, Grid<double>& world, WorldType& worldType) {
+    ifstream input(filename.c_str(), ios::binary);
+    if (input.fail()) {
+        cerr << "Unable to open world file " << filename << endl;
+        return false;
+    }
+    char magic[sizeof(kBinaryWorldMagic)];
+    input.read(magic, sizeof(magic));
+    if (input.gcount() < (streamsize) sizeof(magic)
+            || memcmp(magic, kBinaryWorldMagic, sizeof(magic)) != 0) {
+        input.clear();
+        input.seekg(0);
+        return readWorldFile(input, world, worldType);
+    }
+
+#ifndef _WIN32
+    input.close();
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        cerr << "Unable to open world file " << filename << endl;
+        return false;
+    }
+    size_t size = info.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // the mapping stays valid without the descriptor
+    if (mapping == MAP_FAILED) {
+        cerr << "Unable to map world file " << filename << endl;
+        return false;
+    }
+    bool success = decodeBinaryWorld(static_cast<const unsigned char*>(mapping), size, world, worldType);
+    munmap(mapping, size);
+    return success;
+#else
+    // no mmap here, so read the whole file into memory instead
+    input.seekg(0, ios::end);
+    vector<char> data((size_t) input.tellg());
+    input.seekg(0);
+    input.read(&data[0], data.size());
+    if (input.fail()) {
+        cerr << "Unable to read world file " << filename << endl;
+        return false;
+    }
+    return decodeBinaryWorld(reinterpret_cast<const unsigned char*>(&data[0]), data.size(), world, worldType);
+#endif
+}
+
+/*
+ * Stores a 32-bit unsigned integer as four bytes in little-endian order.
+ */
+static void encodeUint32(unsigned int value, char* bytes) {
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = (char) ((value >> (8 * i)) & 0xff);
+    }
+}
+
+/*
+ * Reads a 32-bit unsigned integer stored as four bytes in little-endian order.
+ */
+static unsigned int decodeUint32(const unsigned char* bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+}
+
+/*
+ * Decodes the complete contents of a binary world file, validating them the
+ * same way readWorldFile validates text files.
+ */
+static bool decodeBinaryWorld(const unsigned char* data, size_t size,
+                              Grid<double>& world, WorldType& worldType) {
+    if (size < kBinaryHeaderSize || memcmp(data, kBinaryWorldMagic, sizeof(kBinaryWorldMagic)) != 0) {
+        cerr << "binary world file has no valid header." << endl;
+        return false;
+    }
+    if (decodeUint32(data + 4) != (unsigned int) kBinaryWorldVersion) {
+        cerr << "binary world file has unsupported version " << decodeUint32(data + 4) << endl;
+        return false;
+    }
+
+    unsigned int type = decodeUint32(data + 8);
+    if (type > 1) {
+        cerr << "binary world file contains invalid type " << type << endl;
+        return false;
+    }
+    worldType = type == 1 ? MAZE_WORLD : TERRAIN_WORLD;
+
+    unsigned int numRows = decodeUint32(data + 12);
+    unsigned int numCols = decodeUint32(data + 16);
+    if (numRows == 0 || numCols == 0 ||
+            numRows >= (unsigned int) kMaxRows || numCols >= (unsigned int) kMaxCols) {
+        cerr << "world file contains invalid number of rows/cols: "
+             << numRows << "," << numCols << endl;
+        return false;
+    }
+    size_t cellSize = worldType == MAZE_WORLD ? 1 : 4;
+    if (size != kBinaryHeaderSize + (size_t) numRows * numCols * cellSize) {
+        cerr << "binary world file has " << size << " bytes, expected "
+             << kBinaryHeaderSize + (size_t) numRows * numCols * cellSize << endl;
+        return false;
+    }
+
+    world.resize(numRows, numCols);
+    const unsigned char* cell = data + kBinaryHeaderSize;
+    for (int row = 0; row < (int) numRows; row++) {
+        for (int col = 0; col < (int) numCols; col++) {
+            double value;
+            if (worldType == MAZE_WORLD) {
+                if (*cell > 1) {
+                    cerr << "world file contains invalid square value of " << (int) *cell
+                         << ", must be 0 or 1" << endl;
+                    return false;
+                }
+                value = *cell == 1 ? kMazeFloor : kMazeWall;
+            } else {
+                unsigned int bits = decodeUint32(cell);
+                float terrain;
+                memcpy(&terrain, &bits, sizeof(terrain));
+                if (!(terrain >= 0.0f && terrain <= 1.0f)) {
+                    cerr << "world file contains invalid terrain value of " << terrain
+                         << ", must be 0.0 - 1.0" << endl;
+                    return false;
+                }
+                value = terrain;
+            }
+            world[row][col] = value;
+            cell += cellSize;
+        }
+    }
+    return true;
+}
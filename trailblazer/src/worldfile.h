@@ -0,0 +1,70 @@
+/*
+ * TDDD86 Trailblazer
+ * This file declares the readers and writer for the maze and terrain world
+ * files in res/, in both their text and binary formats.
+ * It is shared by the GUI and by programs that run without a display, so it
+ * must not depend on any graphics code.
+ * See worldfile.cpp for implementation of each function.
+ *
+ * Author: Marty Stepp, Keith Schwarz, et al
+ * Slight modifications by Tommy Farnqvist
+ */
+
+#ifndef _worldfile_h
+#define _worldfile_h
+
+#include <iostream>
+#include <string>
+#include "grid.h"
+
+/*
+ * An enumerated type tracking what type of world is currently selected so that
+ * we can determine which clicked locations are legal.
+ */
+enum WorldType {
+    TERRAIN_WORLD,
+    MAZE_WORLD
+};
+
+/*
+ * Maximum number of rows or columns we allow in a world.    This is mostly a
+ * safety feature to prevent an OOM on a malformed input file.
+ */
+const int kMaxRows = 400;
+const int kMaxCols = 400;
+
+/*
+ * Tries to read a world file from the specified stream.  On success, returns
+ * true and updates the input parameters to mark the type of the world and
+ * the world contents.  On failure, returns false, but may still modify the
+ * input parameters.
+ */
+bool readWorldFile(std::istream& input, Grid<double>& world, WorldType& worldType);
+
+/*
+ * Binary world files start with these four bytes, and text world files never do.
+ * By convention they are named like the text file with the extension .tbw.
+ */
+const char kBinaryWorldMagic[4] = { 'T', 'B', 'W', 'B' };
+const int kBinaryWorldVersion = 1;
+
+/*
+ * Writes the given world in the binary world format: a 20-byte header holding
+ * the magic bytes followed by the format version, world type (0 for terrain,
+ * 1 for maze), number of rows and number of columns as little-endian 32-bit
+ * integers, and then every cell row by row, as one byte (0 or 1) for mazes or
+ * as a little-endian IEEE float32 for terrains.  Returns false if writing fails.
+ */
+bool writeBinaryWorldFile(std::ostream& output, const Grid<double>& world, WorldType worldType);
+
+/*
+ * Tries to read a world from the file with the given name, which may be a
+ * binary or a text world file.  Binary files are memory-mapped where the system
+ * supports it and their cells are copied straight into the world, which is far
+ * faster than parsing text.  On success, returns true and updates the input
+ * parameters as readWorldFile does; on failure, returns false, but may still
+ * modify the input parameters.
+ */
+bool loadWorldFile(const std::string& filename, Grid<double>& world, WorldType& worldType);
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * Defines the ArrayTour class
+ * @file ArrayTour.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include "ArrayTour.h"
+
+/**
+ * Makes a tour that visits the given points in the given order
+ * @param points - The points of the tour; city i is points[i]
+ */
+ArrayTour::ArrayTour(const std::vector<Point>& points)
+    : _points(points), _order(points.size()), _position(points.size())
+{
+    for (int i = 0; i < size(); i++)
+    {
+        _order[i] = i;
+        _position[i] = i;
+    }
+    _distance = sumDistance();
+}
+
+/**
+ * Makes a tour that visits the given points in another order
+ * @param points - The points of the tour; city i is points[i]
+ * @param order - The cities in the order the tour visits them; each city
+ *                exactly once
+ */
+ArrayTour::ArrayTour(const std::vector<Point>& points, const std::vector<int>& order)
+    : _points(points), _order(order), _position(points.size())
+{
+    for (int i = 0; i < size(); i++)
+    {
+        _position[_order[i]] = i;
+    }
+    _distance = sumDistance();
+}
+
+/**
+ * Prints all the points of the tour to the console
+ */
+void ArrayTour::show() const
+{
+    for (int city : _order)
+    {
+        std::cout << _points[city].toString() << std::endl;
+    }
+}
+
+/**
+ * Draws lines between all the neighbouring points in the tour
+ * @param scene - The scene in which to draw
+ */
+void ArrayTour::draw(QGraphicsScene* scene) const
+{
+    scene->clear();
+
+    for (int i = 0; i < size(); i++)
+    {
+        _points[_order[i]].drawTo(_points[_order[(i + 1) % size()]], scene);
+    }
+}
+
+/**
+ * Sums the distance between all neighbouring points in the tour, one by one
+ * @return The sum of all distances between neighbouring points
+ */
+double ArrayTour::sumDistance() const
+{
+    double distance = 0;
+
+    for (int i = 0; i < size(); i++)
+    {
+        distance += _points[_order[i]].distanceTo(_points[_order[(i + 1) % size()]]);
+    }
+
+    return distance;
+}
+
+/**
+ * Checks, unless NDEBUG is defined, that the distance kept as the tour is
+ * reversed matches the distance summed over the whole tour, up to rounding
+ */
+void ArrayTour::checkDistance() const
+{
+#ifndef NDEBUG
+    double distance = sumDistance();
+    assert(std::fabs(distance - _distance) <= 1e-9 * std::max(1.0, distance));
+#endif
+}
+
+/**
+ * Returns the points of the tour in the order it visits them
+ * @return The points of the tour
+ */
+std::vector<Point> ArrayTour::points() const
+{
+    std::vector<Point> points;
+    points.reserve(size());
+
+    for (int city : _order)
+    {
+        points.push_back(_points[city]);
+    }
+
+    return points;
+}
+
+/**
+ * Returns the city the tour visits after a city
+ * @param city - The city
+ * @return The next city
+ */
+int ArrayTour::next(int city) const
+{
+    int position = _position[city] + 1;
+    return _order[position == size() ? 0 : position];
+}
+
+/**
+ * Returns the city the tour visits before a city
+ * @param city - The city
+ * @return The previous city
+ */
+int ArrayTour::previous(int city) const
+{
+    int position = _position[city];
+    return _order[position == 0 ? size() - 1 : position - 1];
+}
+
+/**
+ * Tells whether walking forward through the tour from city a, city b is
+ * reached no later than city c
+ * @param a - The city to start from
+ * @param b - The city to look for
+ * @param c - The city to stop at
+ * @return True if b lies on the stretch of the tour from a to c
+ */
+bool ArrayTour::between(int a, int b, int c) const
+{
+    int positionA = _position[a];
+    int positionB = _position[b];
+    int positionC = _position[c];
+    if (positionA <= positionC)
+    {
+        return positionA <= positionB && positionB <= positionC;
+    }
+    return positionA <= positionB || positionB <= positionC;
+}
+
+/**
+ * Reverses the stretch of the tour from one position forward to another, both
+ * included, wrapping around the end of the arrays if needed.  When the stretch
+ * is longer than half the tour, the rest of the tour is reversed instead,
+ * which gives the same cycle walked the other way round
+ * @param from - The position of the first city of the stretch
+ * @param to - The position of the last city of the stretch
+ */
+void ArrayTour::reverse(int from, int to)
+{
+    int n = size();
+    int length = to - from + 1;
+    if (length <= 0)
+    {
+        length += n;
+    }
+
+    // The edges into the stretch and out of it now join the other ends of it;
+    // reversing all but one city, or all of them, leaves the same edges
+    if (length < n - 1)
+    {
+        const Point& before = _points[_order[from == 0 ? n - 1 : from - 1]];
+        const Point& first = _points[_order[from]];
+        const Point& last = _points[_order[to]];
+        const Point& after = _points[_order[to + 1 == n ? 0 : to + 1]];
+        _distance += before.distanceTo(last) + first.distanceTo(after)
+                     - before.distanceTo(first) - last.distanceTo(after);
+    }
+    if (2 * length > n)
+    {
+        // Reverse the complement, which is the shorter stretch
+        int newFrom = to + 1 == n ? 0 : to + 1;
+        to = from == 0 ? n - 1 : from - 1;
+        from = newFrom;
+        length = n - length;
+    }
+
+    // Swap the cities at both ends, moving inwards
+    for (int i = 0; i < length / 2; i++)
+    {
+        int cityA = _order[from];
+        int cityB = _order[to];
+        _order[from] = cityB;
+        _position[cityB] = from;
+        _order[to] = cityA;
+        _position[cityA] = to;
+
+        from = from + 1 == n ? 0 : from + 1;
+        to = to == 0 ? n - 1 : to - 1;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * Declares the ArrayTour class, a tour stored as an array of cities
+ * @file ArrayTour.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef ARRAYTOUR_H
+#define ARRAYTOUR_H
+
+#include <vector>
+#include "Point.h"
+
+/*
+ * A tour through points in the plane, stored as arrays instead of a linked
+ * list.  Each point is a city numbered by its index in the vector the tour was
+ * made from.  The order array holds the city at each position of the tour and
+ * the position array the position of each city, so that walking the tour,
+ * finding the neighbors of a city and its place in the tour all take constant
+ * time, and the size is simply the length of the arrays.
+ * The tour is changed by reversing a stretch of it, which is what local search
+ * moves such as 2-opt are made of.  Each reversal adjusts the distance of the
+ * tour by the two edges it changes, so reading the distance is free.
+ */
+class ArrayTour
+{
+public:
+    ArrayTour(const std::vector<Point>& points);
+    ArrayTour(const std::vector<Point>& points, const std::vector<int>& order);
+
+    void show() const;
+    void draw(QGraphicsScene* scene) const;
+    int size() const { return (int) _order.size(); }
+    double distance() const { return _distance; }
+    void checkDistance() const;
+    std::vector<Point> points() const;
+
+    const Point& point(int city) const { return _points[city]; }
+    int city(int position) const { return _order[position]; }
+    int position(int city) const { return _position[city]; }
+    int next(int city) const;
+    int previous(int city) const;
+    bool between(int a, int b, int c) const;
+
+    void reverse(int from, int to);
+
+private:
+    std::vector<Point> _points;     // point of each city
+    std::vector<int> _order;        // city at each position
+    std::vector<int> _position;     // position of each city
+    double _distance;               // kept up to date by reverse
+
+    double sumDistance() const;
+};
+
+#endif // ARRAYTOUR_H
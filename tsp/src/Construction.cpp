@@ -0,0 +1,408 @@
+/**
+ * Defines the heuristics that build a whole tour at once from all its points
+ * @file Construction.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "ArrayTour.h"
+#include "Construction.h"
+#include "NeighborLists.h"
+
+// Number of bits of each coordinate the Hilbert curve resolves
+static const int HILBERT_BITS = 20;
+
+// Number of neighbors per point whose edges the greedy matching and the
+// spanning tree are built from
+static const int CANDIDATE_NEIGHBORS = 10;
+
+// Number of neighbors per path end first tried when joining the paths
+static const int JOIN_NEIGHBORS = 8;
+
+/*
+ * An edge between two points, by their indices.
+ */
+struct Edge
+{
+    double length;
+    int a, b;
+
+    bool operator<(const Edge& other) const { return length < other.length; }
+};
+
+/*
+ * A union-find structure: splits the numbers 0 to n - 1 into disjoint sets,
+ * which can be merged, and finds the set of a number in close to constant time.
+ */
+class DisjointSets
+{
+public:
+    /**
+     * Puts each number in a set of its own
+     * @param n - The number of numbers
+     */
+    DisjointSets(int n)
+        : _parent(n), _size(n, 1)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            _parent[i] = i;
+        }
+    }
+
+    /**
+     * Finds the set of a number, halving the path to its root on the way
+     * @param i - The number
+     * @return The number at the root of its set
+     */
+    int find(int i)
+    {
+        while (_parent[i] != i)
+        {
+            _parent[i] = _parent[_parent[i]];
+            i = _parent[i];
+        }
+        return i;
+    }
+
+    /**
+     * Merges the sets of two numbers, hanging the smaller under the larger
+     * @param a - One number
+     * @param b - The other number
+     * @return False if they were already in the same set
+     */
+    bool join(int a, int b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+        {
+            return false;
+        }
+        if (_size[a] < _size[b])
+        {
+            std::swap(a, b);
+        }
+        _parent[b] = a;
+        _size[a] += _size[b];
+        return true;
+    }
+
+private:
+    std::vector<int> _parent;
+    std::vector<int> _size;
+};
+
+/**
+ * Returns how far along the Hilbert curve over a square of 2^HILBERT_BITS
+ * cells a side a cell lies
+ * @param x - The column of the cell
+ * @param y - The row of the cell
+ * @return The number of cells the curve passes before it
+ */
+static unsigned long long hilbertIndex(unsigned x, unsigned y)
+{
+    const unsigned side = 1u << HILBERT_BITS;
+    unsigned long long index = 0;
+
+    // Pick the quadrant at each level, then turn the coordinates so the
+    // curve within it runs like the curve over the whole square
+    for (unsigned s = side / 2; s > 0; s /= 2)
+    {
+        unsigned rx = (x & s) != 0;
+        unsigned ry = (y & s) != 0;
+        index += (unsigned long long) s * s * ((3 * rx) ^ ry);
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+/**
+ * Orders points along a Hilbert curve
+ * @param points - The points to visit
+ * @return The indices of the points in the order to visit them
+ */
+std::vector<int> hilbertOrder(const std::vector<Point>& points)
+{
+    int n = points.size();
+    double minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    for (const Point& p : points)
+    {
+        minX = std::min(minX, p.x);
+        minY = std::min(minY, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+
+    // Scale both axes alike so that the curve keeps distances in proportion
+    double extent = std::max(maxX - minX, maxY - minY);
+    double scale = extent > 0 ? ((1u << HILBERT_BITS) - 1) / extent : 0;
+
+    std::vector<std::pair<unsigned long long, int>> byIndex(n);
+    for (int i = 0; i < n; i++)
+    {
+        unsigned x = (unsigned) ((points[i].x - minX) * scale);
+        unsigned y = (unsigned) ((points[i].y - minY) * scale);
+        byIndex[i] = std::make_pair(hilbertIndex(x, y), i);
+    }
+    std::sort(byIndex.begin(), byIndex.end());
+
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+    {
+        order[i] = byIndex[i].second;
+    }
+    return order;
+}
+
+/**
+ * Returns the edges between some of the points and their nearest neighbors
+ * among them, each edge once, shortest first
+ * @param points - All the points
+ * @param subset - The indices of the points to use
+ * @param k - The number of neighbors per point
+ * @return The edges
+ */
+static std::vector<Edge> neighborEdges(const std::vector<Point>& points, const std::vector<int>& subset, int k)
+{
+    std::vector<Point> subsetPoints;
+    subsetPoints.reserve(subset.size());
+    for (int i : subset)
+    {
+        subsetPoints.push_back(points[i]);
+    }
+    NeighborLists neighbors(ArrayTour(subsetPoints), k);
+
+    std::vector<Edge> edges;
+    edges.reserve(subset.size() * neighbors.k());
+    for (int a = 0; a < (int) subset.size(); a++)
+    {
+        const int* near = neighbors.of(a);
+        for (int i = 0; i < neighbors.k(); i++)
+        {
+            int b = near[i];
+            const int* nearB = neighbors.of(b);
+            if (a > b && std::find(nearB, nearB + neighbors.k(), a) != nearB + neighbors.k())
+            {
+                continue; // Already added from b's side
+            }
+            edges.push_back({ subsetPoints[a].distanceTo(subsetPoints[b]), subset[a], subset[b] });
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+/**
+ * Returns the number of edges a point has been given
+ * @param links - The up to two points each point is linked to, -1 for none
+ * @param i - The point
+ * @return 0, 1 or 2
+ */
+static int degree(const std::vector<int>& links, int i)
+{
+    return (links[2 * i] >= 0) + (links[2 * i + 1] >= 0);
+}
+
+/**
+ * Links two points with an edge
+ * @param links - The up to two points each point is linked to, -1 for none
+ * @param a - One point
+ * @param b - The other point
+ */
+static void link(std::vector<int>& links, int a, int b)
+{
+    links[2 * a + (links[2 * a] >= 0)] = b;
+    links[2 * b + (links[2 * b] >= 0)] = a;
+}
+
+/**
+ * Adds edges greedily, shortest first, to a set of paths, skipping any that
+ * would give a point a third edge or close a cycle
+ * @param edges - The edges to try, shortest first
+ * @param paths - The path of each point; kept up to date
+ * @param links - The up to two points each point is linked to; kept up to date
+ * @return The number of edges added
+ */
+static int addGreedyEdges(const std::vector<Edge>& edges, DisjointSets& paths, std::vector<int>& links)
+{
+    int added = 0;
+    for (const Edge& edge : edges)
+    {
+        if (degree(links, edge.a) < 2 && degree(links, edge.b) < 2 && paths.join(edge.a, edge.b))
+        {
+            link(links, edge.a, edge.b);
+            added++;
+        }
+    }
+    return added;
+}
+
+/**
+ * Joins a set of paths through all the points into one by greedy matching of
+ * their ends, in rounds.  A round that adds no edge is retried with twice the
+ * neighbors, so the rounds end at the latest once every end is a neighbor of
+ * every other
+ * @param points - All the points
+ * @param paths - The path of each point; kept up to date
+ * @param links - The up to two points each point is linked to; kept up to date
+ * @param numEdges - The number of edges the paths have
+ */
+static void joinPaths(const std::vector<Point>& points, DisjointSets& paths, std::vector<int>& links, int numEdges)
+{
+    int n = points.size();
+    int k = JOIN_NEIGHBORS;
+    while (numEdges < n - 1)
+    {
+        std::vector<int> ends;
+        for (int i = 0; i < n; i++)
+        {
+            if (degree(links, i) < 2)
+            {
+                ends.push_back(i);
+            }
+        }
+
+        int added = addGreedyEdges(neighborEdges(points, ends, k), paths, links);
+        numEdges += added;
+        if (added == 0)
+        {
+            k *= 2;
+        }
+    }
+}
+
+/**
+ * Walks a path through all the points from one end to the other
+ * @param links - The up to two points each point is linked to
+ * @return The indices of the points in the order the path visits them
+ */
+static std::vector<int> walkPath(const std::vector<int>& links)
+{
+    int n = links.size() / 2;
+    int current = 0;
+    while (degree(links, current) == 2)
+    {
+        current++;
+    }
+
+    std::vector<int> order;
+    order.reserve(n);
+    int previous = -1;
+    for (int i = 0; i < n; i++)
+    {
+        order.push_back(current);
+        int next = links[2 * current] != previous ? links[2 * current] : links[2 * current + 1];
+        previous = current;
+        current = next;
+    }
+    return order;
+}
+
+/**
+ * Orders points by greedy edge matching
+ * @param points - The points to visit
+ * @return The indices of the points in the order to visit them
+ */
+std::vector<int> greedyEdgeOrder(const std::vector<Point>& points)
+{
+    int n = points.size();
+    std::vector<int> all(n);
+    for (int i = 0; i < n; i++)
+    {
+        all[i] = i;
+    }
+    if (n < 3)
+    {
+        return all;
+    }
+
+    DisjointSets paths(n);
+    std::vector<int> links(2 * n, -1);
+    int numEdges = addGreedyEdges(neighborEdges(points, all, CANDIDATE_NEIGHBORS), paths, links);
+    joinPaths(points, paths, links, numEdges);
+    return walkPath(links);
+}
+
+/**
+ * Orders points by a depth first walk around a minimum spanning tree
+ * @param points - The points to visit
+ * @return The indices of the points in the order to visit them
+ */
+std::vector<int> spanningTreeOrder(const std::vector<Point>& points)
+{
+    int n = points.size();
+    std::vector<int> all(n);
+    for (int i = 0; i < n; i++)
+    {
+        all[i] = i;
+    }
+    if (n < 3)
+    {
+        return all;
+    }
+
+    // Kruskal's algorithm; the edges come shortest first, so each point's
+    // list of tree neighbors does too
+    DisjointSets trees(n);
+    std::vector<std::vector<int>> treeNeighbors(n);
+    for (const Edge& edge : neighborEdges(points, all, CANDIDATE_NEIGHBORS))
+    {
+        if (trees.join(edge.a, edge.b))
+        {
+            treeNeighbors[edge.a].push_back(edge.b);
+            treeNeighbors[edge.b].push_back(edge.a);
+        }
+    }
+
+    // Link the points of each tree in the order a depth first walk reaches
+    // them, nearest neighbor first, into a path per tree
+    DisjointSets paths(n);
+    std::vector<int> links(2 * n, -1);
+    int numEdges = 0;
+    std::vector<bool> isReached(n, false);
+    std::vector<int> stack;
+    for (int root = 0; root < n; root++)
+    {
+        if (isReached[root])
+        {
+            continue;
+        }
+        int previous = -1;
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int current = stack.back();
+            stack.pop_back();
+            isReached[current] = true;
+            if (previous >= 0)
+            {
+                link(links, previous, current);
+                paths.join(previous, current);
+                numEdges++;
+            }
+            previous = current;
+
+            for (auto it = treeNeighbors[current].rbegin(); it != treeNeighbors[current].rend(); ++it)
+            {
+                if (!isReached[*it])
+                {
+                    stack.push_back(*it);
+                }
+            }
+        }
+    }
+
+    joinPaths(points, paths, links, numEdges);
+    return walkPath(links);
+}
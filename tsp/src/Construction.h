@@ -0,0 +1,49 @@
+/**
+ * Declares the heuristics that build a whole tour at once from all its points
+ * @file Construction.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef CONSTRUCTION_H
+#define CONSTRUCTION_H
+
+#include <vector>
+#include "Point.h"
+
+/*
+ * Unlike the insertion heuristics of Tour, which take the points one at a
+ * time, these need all the points up front.  Each returns the order to visit
+ * them in, as indices into the vector, which an ArrayTour or a Tour can be
+ * made from.
+ */
+
+/*
+ * Visits the points in the order a Hilbert curve over their bounding square
+ * passes them.  The curve never jumps, so points close along it are close in
+ * the plane, and the tour comes out some 25-40% longer than a good one; this
+ * takes only a sort, O(n log n), which makes it a fast start for local search.
+ */
+std::vector<int> hilbertOrder(const std::vector<Point>& points);
+
+/*
+ * Greedy edge matching: goes through the edges between each point and its
+ * nearest neighbors, shortest first, and keeps every edge that neither gives a
+ * point a third edge nor closes a cycle.  This leaves paths, whose ends are
+ * then joined the same way, with more neighbors if needed, into one path that
+ * the tour closes.  Greedy tours are usually 10-20% longer than optimal and
+ * make the best start for local search of these, at the cost of a sort of
+ * the edges.
+ */
+std::vector<int> greedyEdgeOrder(const std::vector<Point>& points);
+
+/*
+ * Spanning tree doubling: builds a minimum spanning tree, by Kruskal's
+ * algorithm over the edges between each point and its nearest neighbors, and
+ * visits the points in the order a depth first walk around the tree first
+ * reaches them, which is never more than twice as long as the tree.  Should the
+ * neighbor edges leave the points in several trees, the walks of the trees are
+ * joined as in greedyEdgeOrder.
+ */
+std::vector<int> spanningTreeOrder(const std::vector<Point>& points);
+
+#endif // CONSTRUCTION_H
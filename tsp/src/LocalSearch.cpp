@@ -0,0 +1,487 @@
+/**
+ * Defines the local search that improves a finished tour
+ * @file LocalSearch.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <vector>
+#include "LocalSearch.h"
+
+// Smallest gain a move must give to be made; guards against rounding loops
+static const double MIN_GAIN = 1e-10;
+
+// Longest stretch of cities Or-opt moves
+static const int MAX_SEGMENT = 3;
+
+// Most 2-opt moves one Lin-Kernighan step chains
+static const int MAX_DEPTH = 5;
+
+// Number of cities tried between looks at the clock
+static const int DEADLINE_INTERVAL = 256;
+
+/*
+ * The cities whose don't-look bit is clear, in the order they are to be tried.
+ */
+class ActiveCities
+{
+public:
+    /**
+     * Starts with every city of a tour active, in tour order
+     * @param tour - The tour
+     */
+    ActiveCities(const ArrayTour& tour)
+        : _isActive(tour.size(), true)
+    {
+        for (int i = 0; i < tour.size(); i++)
+        {
+            _queue.push_back(tour.city(i));
+        }
+    }
+
+    bool isEmpty() const { return _queue.empty(); }
+
+    /**
+     * Takes the next city to try, setting its don't-look bit
+     * @return The city
+     */
+    int pop()
+    {
+        int city = _queue.front();
+        _queue.pop_front();
+        _isActive[city] = false;
+        return city;
+    }
+
+    /**
+     * Clears the don't-look bit of a city, queueing it if it was set
+     * @param city - The city
+     */
+    void push(int city)
+    {
+        if (!_isActive[city])
+        {
+            _isActive[city] = true;
+            _queue.push_back(city);
+        }
+    }
+
+private:
+    std::deque<int> _queue;
+    std::vector<bool> _isActive;
+};
+
+/**
+ * Returns the distance between two cities of a tour
+ * @param tour - The tour
+ * @param a - One city
+ * @param b - The other city
+ * @return The distance between them
+ */
+static double cityDistance(const ArrayTour& tour, int a, int b)
+{
+    return tour.point(a).distanceTo(tour.point(b));
+}
+
+/**
+ * Tells whether a search has run out of time; only looks at the clock every
+ * DEADLINE_INTERVAL calls
+ * @param deadline - The moment to stop by
+ * @param calls - Counts the calls
+ * @return True if the deadline has passed
+ */
+static bool isPast(Deadline deadline, int& calls)
+{
+    return deadline != NO_DEADLINE && ++calls % DEADLINE_INTERVAL == 0
+           && std::chrono::steady_clock::now() >= deadline;
+}
+
+/**
+ * Replaces the edges (a, b) and (c, d) of a tour with (a, c) and (b, d), where
+ * d is the city after c walking from a to b, by reversing the path from b to c
+ * @param tour - The tour
+ * @param a - The city before b
+ * @param b - The first city of the path to reverse
+ * @param c - The last city of the path to reverse
+ */
+static void makeTwoOptMove(ArrayTour& tour, int a, int b, int c)
+{
+    if (tour.next(a) == b)
+        tour.reverse(tour.position(b), tour.position(c));
+    else
+        tour.reverse(tour.position(c), tour.position(b)); // Walking backward, so the path runs from c to b
+}
+
+/**
+ * Tries the 2-opt moves that remove the edge from a city to its successor, or
+ * to its predecessor, and add an edge from the city to one of its neighbors;
+ * makes the first one that shortens the tour
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param a - The city whose moves to try
+ * @param active - The cities whose edges a move changes are made active
+ * @return True if a move was made
+ */
+static bool improveTwoOpt(ArrayTour& tour, const NeighborLists& neighbors, int a, ActiveCities& active)
+{
+    for (int forward = 1; forward >= 0; forward--)
+    {
+        int b = forward ? tour.next(a) : tour.previous(a);
+        double removedAB = cityDistance(tour, a, b);
+        const int* near = neighbors.of(a);
+
+        for (int i = 0; i < neighbors.k(); i++)
+        {
+            int c = near[i];
+            double addedAC = cityDistance(tour, a, c);
+            if (addedAC >= removedAB)
+            {
+                break; // The lists are sorted, so no later neighbor can gain either
+            }
+
+            int d = forward ? tour.next(c) : tour.previous(c);
+            if (c == b || d == a)
+            {
+                continue;
+            }
+            double gain = removedAB + cityDistance(tour, c, d) - addedAC - cityDistance(tour, b, d);
+            if (gain > MIN_GAIN)
+            {
+                // a b ... c d becomes a c ... b d
+                makeTwoOptMove(tour, a, b, c);
+                active.push(a);
+                active.push(b);
+                active.push(c);
+                active.push(d);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Improves a tour by 2-opt moves between neighboring cities until none is left
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param deadline - The moment to stop by
+ * @return The number of moves made
+ */
+int twoOpt(ArrayTour& tour, const NeighborLists& neighbors, Deadline deadline)
+{
+    if (tour.size() < 4)
+    {
+        return 0;
+    }
+
+    ActiveCities active(tour);
+    int moves = 0;
+    int calls = 0;
+    while (!active.isEmpty() && !isPast(deadline, calls))
+    {
+        if (improveTwoOpt(tour, neighbors, active.pop(), active))
+        {
+            moves++;
+        }
+    }
+    return moves;
+}
+
+/**
+ * Moves the stretch s1 ... s2 of a tour, which lies between p and n, to
+ * between c and the city e after c walking from n away from the stretch, so
+ * that c is next to s2 and e next to s1, or the other way round if keepOrder
+ * is true; c must not be p.  The move is made of two or three 2-opt moves
+ * @param tour - The tour
+ * @param p - The city before the stretch
+ * @param s1 - The first city of the stretch
+ * @param s2 - The last city of the stretch
+ * @param n - The city after the stretch
+ * @param c - The city the stretch goes after
+ * @param keepOrder - Whether c is to be next to s1 rather than s2
+ */
+static void moveSegment(ArrayTour& tour, int p, int s1, int s2, int n, int c, bool keepOrder)
+{
+    makeTwoOptMove(tour, p, s1, c);         // p s1..s2 n ... c e  ->  p c ... n s2..s1 e
+    makeTwoOptMove(tour, p, c, n);          // p c ... n s2..s1 e  ->  p n ... c s2..s1 e
+    if (keepOrder)
+        makeTwoOptMove(tour, c, s2, s1);    // c s2..s1 e  ->  c s1..s2 e
+}
+
+/**
+ * Tries the Or-opt moves of the stretches of one to three cities that start at
+ * a city, into edges next to the neighbors of their ends; makes the first one
+ * that shortens the tour
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param s1 - The city whose moves to try
+ * @param active - The cities whose edges a move changes are made active
+ * @return True if a move was made
+ */
+static bool improveOrOpt(ArrayTour& tour, const NeighborLists& neighbors, int s1, ActiveCities& active)
+{
+    int p = tour.previous(s1);
+    int s2 = s1;
+    for (int length = 1; length <= MAX_SEGMENT; length++, s2 = tour.next(s2))
+    {
+        int n = tour.next(s2);
+        if (n == p || tour.next(n) == p)
+        {
+            return false; // Too few cities left outside the stretch
+        }
+        double removed = cityDistance(tour, p, s1) + cityDistance(tour, s2, n) - cityDistance(tour, p, n);
+
+        // Put either end of the stretch next to one of its neighbors
+        for (int end = 0; end < 2; end++)
+        {
+            int s = end == 0 ? s1 : s2;
+            const int* near = neighbors.of(s);
+            for (int i = 0; i < neighbors.k(); i++)
+            {
+                int c = near[i];
+                double addedSC = cityDistance(tour, s, c);
+                if (addedSC >= removed)
+                {
+                    break;
+                }
+                if (tour.between(s1, c, s2))
+                {
+                    continue; // c is in the stretch itself
+                }
+
+                // Either edge of c will do, as long as it does not touch the stretch
+                for (int after = 0; after < 2; after++)
+                {
+                    int x = after ? c : tour.previous(c);
+                    int y = tour.next(x);
+                    if (x == p || tour.between(s1, x, s2) || tour.between(s1, y, s2))
+                    {
+                        continue;
+                    }
+
+                    // s goes next to c; the other end of the stretch next to the other city
+                    int other = end == 0 ? s2 : s1;
+                    int d = x == c ? y : x;
+                    double added = addedSC + cityDistance(tour, other, d) - cityDistance(tour, x, y);
+                    if (removed - added <= MIN_GAIN)
+                    {
+                        continue;
+                    }
+
+                    // The walk from n away from the stretch reaches x before y
+                    // unless y is p; then walk the other way
+                    bool sNextToX = x == c;
+                    bool s1NextToX = (s == s1) == sNextToX;
+                    if (y != p)
+                        moveSegment(tour, p, s1, s2, n, x, s1NextToX);
+                    else
+                        moveSegment(tour, n, s2, s1, p, y, s1NextToX);
+
+                    active.push(p);
+                    active.push(n);
+                    active.push(s1);
+                    active.push(s2);
+                    active.push(x);
+                    active.push(y);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Improves a tour by Or-opt moves near neighboring cities until none is left
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param deadline - The moment to stop by
+ * @return The number of moves made
+ */
+int orOpt(ArrayTour& tour, const NeighborLists& neighbors, Deadline deadline)
+{
+    if (tour.size() < 2 * MAX_SEGMENT + 2)
+    {
+        return 0;
+    }
+
+    ActiveCities active(tour);
+    int moves = 0;
+    int calls = 0;
+    while (!active.isEmpty() && !isPast(deadline, calls))
+    {
+        if (improveOrOpt(tour, neighbors, active.pop(), active))
+        {
+            moves++;
+        }
+    }
+    return moves;
+}
+
+/**
+ * Runs one Lin-Kernighan step from a city, in both directions: chains 2-opt
+ * moves that each break the edge from t1 the last one added, and keeps the
+ * chain up to its best point if that shortens the tour
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param t1 - The city the chain starts from, which stays fixed
+ * @param active - The cities whose edges the kept moves changed are made active
+ * @return True if the tour was improved
+ */
+static bool improveLinKernighan(ArrayTour& tour, const NeighborLists& neighbors, int t1, ActiveCities& active)
+{
+    int chain[MAX_DEPTH][2];   // t2 and t3 of each move of the chain, t4 being the next t2
+
+    for (int forward = 1; forward >= 0; forward--)
+    {
+        int t2 = forward ? tour.next(t1) : tour.previous(t1);
+        double gain = cityDistance(tour, t1, t2); // Removed minus added, leaving out the closing edge
+        double bestGain = 0;
+        int bestDepth = 0;
+        int depth = 0;
+
+        while (depth < MAX_DEPTH)
+        {
+            // Walking from t1 towards t2, pick the neighbor t3 of t2 whose
+            // predecessor t4 gives the best partial gain after the move
+            bool isForward = tour.next(t1) == t2;
+            int bestT3 = -1;
+            double bestStepGain = -INFINITY;
+            const int* near = neighbors.of(t2);
+            for (int i = 0; i < neighbors.k(); i++)
+            {
+                int t3 = near[i];
+                double partialGain = gain - cityDistance(tour, t2, t3);
+                if (partialGain <= MIN_GAIN)
+                {
+                    break;
+                }
+                int t4 = isForward ? tour.previous(t3) : tour.next(t3);
+                if (t3 == t1 || t4 == t2)
+                {
+                    continue;
+                }
+                double stepGain = partialGain + cityDistance(tour, t3, t4);
+                if (stepGain > bestStepGain)
+                {
+                    bestStepGain = stepGain;
+                    bestT3 = t3;
+                }
+            }
+            if (bestT3 < 0)
+            {
+                break;
+            }
+
+            // Remove (t1, t2) and (t4, t3), add (t2, t3) and the closing edge (t1, t4)
+            int t3 = bestT3;
+            int t4 = isForward ? tour.previous(t3) : tour.next(t3);
+            makeTwoOptMove(tour, t1, t2, t4);
+            chain[depth][0] = t2;
+            chain[depth][1] = t3;
+            depth++;
+
+            gain = bestStepGain;
+            if (gain - cityDistance(tour, t1, t4) > bestGain + MIN_GAIN)
+            {
+                bestGain = gain - cityDistance(tour, t1, t4);
+                bestDepth = depth;
+            }
+            t2 = t4;
+        }
+
+        // Undo the moves past the best point, last first
+        while (depth > bestDepth)
+        {
+            depth--;
+            int t4 = t2;
+            int t2Before = chain[depth][0];
+            makeTwoOptMove(tour, t1, t4, t2Before);
+            t2 = t2Before;
+        }
+
+        if (bestDepth > 0)
+        {
+            active.push(t1);
+            for (int i = 0; i < bestDepth; i++)
+            {
+                active.push(chain[i][0]);
+                active.push(chain[i][1]);
+                active.push(tour.next(chain[i][1]));
+                active.push(tour.previous(chain[i][1]));
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Improves a tour by Lin-Kernighan style chains of 2-opt moves until none is left
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param deadline - The moment to stop by
+ * @return The number of improving chains made
+ */
+int linKernighan(ArrayTour& tour, const NeighborLists& neighbors, Deadline deadline)
+{
+    if (tour.size() < 8)
+    {
+        return 0;
+    }
+
+    ActiveCities active(tour);
+    int moves = 0;
+    int calls = 0;
+    while (!active.isEmpty() && !isPast(deadline, calls))
+    {
+        if (improveLinKernighan(tour, neighbors, active.pop(), active))
+        {
+            moves++;
+        }
+    }
+    return moves;
+}
+
+/**
+ * Improves a tour with all the local searches in turn, within a time budget
+ * @param tour - The tour to improve
+ * @param neighbors - The neighbor lists of the cities of the tour
+ * @param seconds - The time budget
+ * @param progress - The stream to report each search on, or nullptr
+ * @return The distance of the improved tour
+ */
+double optimizeTour(ArrayTour& tour, const NeighborLists& neighbors, double seconds,
+                    std::ostream* progress)
+{
+    typedef int (*Search)(ArrayTour&, const NeighborLists&, Deadline);
+    const Search searches[] = { twoOpt, orOpt, linKernighan };
+    const char* const names[] = { "2-opt", "Or-opt", "Lin-Kernighan" };
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Deadline deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(seconds));
+
+    bool improved = true;
+    while (improved && std::chrono::steady_clock::now() < deadline)
+    {
+        improved = false;
+        for (int i = 0; i < 3; i++)
+        {
+            int moves = searches[i](tour, neighbors, deadline);
+            improved = improved || moves > 0;
+            tour.checkDistance();
+            if (progress != nullptr)
+            {
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                *progress << std::setw(14) << std::left << names[i] << std::right
+                          << std::setw(8) << moves << " moves   distance "
+                          << std::fixed << std::setprecision(4) << tour.distance()
+                          << "   " << std::setprecision(3) << elapsed << " s" << std::endl;
+            }
+        }
+    }
+    return tour.distance();
+}
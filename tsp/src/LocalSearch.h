@@ -0,0 +1,63 @@
+/**
+ * Declares the local search that improves a finished tour
+ * @file LocalSearch.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef LOCALSEARCH_H
+#define LOCALSEARCH_H
+
+#include <chrono>
+#include <iostream>
+#include "ArrayTour.h"
+#include "NeighborLists.h"
+
+/*
+ * The moment a search has to stop by; the searches check it every few hundred
+ * cities and return early, with the tour valid, once it has passed.
+ */
+typedef std::chrono::steady_clock::time_point Deadline;
+const Deadline NO_DEADLINE = Deadline::max();
+
+/*
+ * All the searches below only try moves that add an edge from a city to one
+ * of its neighbors in the lists, as good tours rarely contain any other edges.
+ * Each city has a don't-look bit: a city whose moves have all been tried
+ * without success is skipped until a move changes one of its edges, and a
+ * search ends when every city's bit is set.
+ * Each returns the number of moves it made.
+ */
+
+/*
+ * 2-opt: removes two edges of the tour and reconnects the two paths the other
+ * way round, reversing one of them, as long as that makes the tour shorter.
+ */
+int twoOpt(ArrayTour& tour, const NeighborLists& neighbors, Deadline deadline = NO_DEADLINE);
+
+/*
+ * Or-opt: moves a stretch of one to three cities to between two other
+ * neighboring cities, either way round, as long as that makes the tour shorter.
+ */
+int orOpt(ArrayTour& tour, const NeighborLists& neighbors, Deadline deadline = NO_DEADLINE);
+
+/*
+ * A Lin-Kernighan style search: starting from an edge of the tour, chains up
+ * to five 2-opt moves, each one breaking the edge the previous one closed the
+ * tour with.  A step may make the tour longer as long as the edges removed so
+ * far outweigh the edges added, which finds improving 3-opt and deeper moves
+ * that no single 2-opt move can; the chain is cut back to its best point, or
+ * undone entirely if no point of it was better than the start.
+ */
+int linKernighan(ArrayTour& tour, const NeighborLists& neighbors, Deadline deadline = NO_DEADLINE);
+
+/*
+ * Runs 2-opt, Or-opt and the Lin-Kernighan style search over and over until a
+ * round of all three makes no move or the given number of seconds has passed.
+ * If progress is not nullptr, a line with the moves made, the distance of the
+ * tour and the time spent so far is written to it after each search.
+ * Returns the distance of the improved tour.
+ */
+double optimizeTour(ArrayTour& tour, const NeighborLists& neighbors, double seconds,
+                    std::ostream* progress = nullptr);
+
+#endif // LOCALSEARCH_H
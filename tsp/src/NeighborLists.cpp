@@ -0,0 +1,231 @@
+/**
+ * Defines the NeighborLists class
+ * @file NeighborLists.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "NeighborLists.h"
+#include "PointArray.h"
+
+// Most cities in a leaf of the k-d tree
+static const int LEAF_SIZE = 16;
+
+/*
+ * A k-d tree over the cities of a tour: each box is split in two at the
+ * median city along its longer side, down to leaves of a few cities.  Since
+ * the splits follow the cities rather than the plane, the tree is about
+ * log2(n / LEAF_SIZE) deep however the cities are spread.  The cities are
+ * stored in the order of the leaves, with their points in a PointArray, so
+ * that the distances to a whole leaf can be worked out at once.
+ */
+class KdTree
+{
+public:
+    /**
+     * Builds the tree over the cities of a tour
+     * @param tour - The tour
+     */
+    KdTree(const ArrayTour& tour)
+        : _tour(tour), _cities(tour.size())
+    {
+        for (int city = 0; city < tour.size(); city++)
+        {
+            _cities[city] = city;
+        }
+        build(0, tour.size());
+
+        _points.reserve(tour.size());
+        for (int city : _cities)
+        {
+            _points.add(tour.point(city));
+        }
+        _distances.resize(LEAF_SIZE);
+    }
+
+    /**
+     * Returns the cities in the order of the leaves, in which cities near
+     * each other in the plane tend to be near each other
+     * @return The cities
+     */
+    const std::vector<int>& cities() const
+    {
+        return _cities;
+    }
+
+    /**
+     * Finds the k nearest other cities of a city, the nearer first and, of
+     * those as near, the lower numbered
+     * @param city - The city
+     * @param k - The number of neighbors to find; at most the number of other cities
+     * @param nearest - Receives the distances and numbers of the neighbors
+     */
+    void findNearest(int city, int k, std::vector<std::pair<double, int>>& nearest)
+    {
+        nearest.clear();
+        search(0, _tour.point(city), city, k, nearest);
+    }
+
+private:
+    /*
+     * A box of the tree, holding the cities from begin to end, whose points
+     * lie within minX, minY, maxX and maxY.
+     */
+    struct Box
+    {
+        double minX, minY, maxX, maxY;
+        int begin, end;
+        int children[2];    // -1 in a leaf
+    };
+
+    const ArrayTour& _tour;
+    std::vector<int> _cities;
+    std::vector<Box> _boxes;
+    PointArray _points;
+    std::vector<double> _distances;
+
+    /**
+     * Adds the box holding some of the cities to the tree, and the boxes below it
+     * @param begin - The first of the cities in _cities
+     * @param end - One past the last of them
+     * @return The index of the box
+     */
+    int build(int begin, int end)
+    {
+        Box box;
+        box.minX = box.minY = INFINITY;
+        box.maxX = box.maxY = -INFINITY;
+        for (int i = begin; i < end; i++)
+        {
+            const Point& p = _tour.point(_cities[i]);
+            box.minX = std::min(box.minX, p.x);
+            box.minY = std::min(box.minY, p.y);
+            box.maxX = std::max(box.maxX, p.x);
+            box.maxY = std::max(box.maxY, p.y);
+        }
+        box.begin = begin;
+        box.end = end;
+        box.children[0] = box.children[1] = -1;
+        int index = _boxes.size();
+        _boxes.push_back(box);
+
+        if (end - begin > LEAF_SIZE)
+        {
+            bool byX = box.maxX - box.minX >= box.maxY - box.minY;
+            const ArrayTour& tour = _tour;
+            int middle = begin + (end - begin) / 2;
+            std::nth_element(_cities.begin() + begin, _cities.begin() + middle, _cities.begin() + end,
+                             [&tour, byX](int a, int b)
+                             {
+                                 double u = byX ? tour.point(a).x : tour.point(a).y;
+                                 double v = byX ? tour.point(b).x : tour.point(b).y;
+                                 return u < v || (u == v && a < b);
+                             });
+            int first = build(begin, middle);
+            int second = build(middle, end);
+            _boxes[index].children[0] = first;
+            _boxes[index].children[1] = second;
+        }
+        return index;
+    }
+
+    /**
+     * Returns the distance from a point to the nearest point of a box
+     * @param box - The box
+     * @param p - The point
+     * @return The distance, 0 if the point lies in the box
+     */
+    static double distanceTo(const Box& box, const Point& p)
+    {
+        double dx = std::max(std::max(box.minX - p.x, p.x - box.maxX), 0.0);
+        double dy = std::max(std::max(box.minY - p.y, p.y - box.maxY), 0.0);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    /**
+     * Adds the cities of a box that are nearer to a point than those found
+     * so far to the nearest cities, looking into the nearer child box first
+     * and skipping boxes that lie too far away
+     * @param index - The index of the box
+     * @param p - The point of the city
+     * @param city - The city, which is skipped
+     * @param k - The number of neighbors to find
+     * @param nearest - The nearest cities found so far, nearest first
+     */
+    void search(int index, const Point& p, int city, int k, std::vector<std::pair<double, int>>& nearest)
+    {
+        const Box& box = _boxes[index];
+        if (box.children[0] < 0)
+        {
+            _points.distancesFrom(p, box.begin, box.end, _distances.data());
+            for (int i = box.begin; i < box.end; i++)
+            {
+                std::pair<double, int> entry(_distances[i - box.begin], _cities[i]);
+                if (entry.second == city || ((int) nearest.size() == k && !(entry < nearest.back())))
+                {
+                    continue;
+                }
+
+                // Keep the list sorted by moving the new entry down into place
+                if ((int) nearest.size() == k)
+                {
+                    nearest.pop_back();
+                }
+                nearest.push_back(entry);
+                for (int j = nearest.size() - 1; j > 0 && nearest[j] < nearest[j - 1]; j--)
+                {
+                    std::swap(nearest[j], nearest[j - 1]);
+                }
+            }
+            return;
+        }
+
+        int children[2] = { box.children[0], box.children[1] };
+        double distances[2] = { distanceTo(_boxes[children[0]], p), distanceTo(_boxes[children[1]], p) };
+        if (distances[1] < distances[0])
+        {
+            std::swap(children[0], children[1]);
+            std::swap(distances[0], distances[1]);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            // A city as near as the kth may still come first by its number
+            if ((int) nearest.size() < k || distances[i] <= nearest.back().first)
+            {
+                search(children[i], p, city, k, nearest);
+            }
+        }
+    }
+};
+
+/**
+ * Finds the nearest neighbors of every city of a tour
+ * @param tour - The tour whose cities to use
+ * @param k - The number of neighbors to find per city; fewer if the tour has
+ *            no more other cities
+ */
+NeighborLists::NeighborLists(const ArrayTour& tour, int k)
+{
+    int n = tour.size();
+    _k = std::max(0, std::min(k, n - 1));
+    _neighbors.resize(n * _k);
+    if (_k == 0)
+    {
+        return;
+    }
+
+    // Going through the cities in the order of the tree keeps the boxes
+    // searched for one city in the cache for the next
+    KdTree tree(tour);
+    std::vector<std::pair<double, int>> nearest;
+    for (int city : tree.cities())
+    {
+        tree.findNearest(city, _k, nearest);
+        for (int i = 0; i < _k; i++)
+        {
+            _neighbors[city * _k + i] = nearest[i].second;
+        }
+    }
+}
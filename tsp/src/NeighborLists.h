@@ -0,0 +1,35 @@
+/**
+ * Declares the NeighborLists class, the nearest neighbors of every city of a tour
+ * @file NeighborLists.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef NEIGHBORLISTS_H
+#define NEIGHBORLISTS_H
+
+#include <vector>
+#include "ArrayTour.h"
+
+/*
+ * For every city of a tour, its k nearest other cities, nearest first.  Local
+ * search only tries moves that join a city to one of its near neighbors, as
+ * good tours rarely contain any other edges.
+ * The lists are found with a k-d tree split at the median city, so building
+ * them takes O(n log n) time however the cities are spread.  Of cities as
+ * near as each other, the lower numbered comes first.  The lists are stored
+ * back to back, k entries per city.
+ */
+class NeighborLists
+{
+public:
+    NeighborLists(const ArrayTour& tour, int k);
+
+    int k() const { return _k; }
+    const int* of(int city) const { return &_neighbors[city * _k]; }
+
+private:
+    int _k;
+    std::vector<int> _neighbors;
+};
+
+#endif // NEIGHBORLISTS_H
@@ -0,0 +1,286 @@
+/**
+ * Defines the solver that builds and improves a tour on several threads
+ * @file ParallelSolver.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+#include <utility>
+#include "LocalSearch.h"
+#include "NeighborLists.h"
+#include "ParallelSolver.h"
+#include "Tour.h"
+
+// Fewest cities a strip is given, so that small problems use fewer threads
+static const int MIN_CITIES_PER_STRIP = 1000;
+
+// Share of the time budget the strips are improved for
+static const double STRIP_SHARE = 0.5;
+
+// Number of neighbors per city the local search and the merging look at
+static const int NUM_NEIGHBORS = 8;
+
+/*
+ * A way to join two tours: remove the edges (a, a2) and (b, b2), one from
+ * each tour, and add (a, b) and (a2, b2), which lengthens the tour by cost.
+ */
+struct Join
+{
+    double cost;
+    int a, a2, b, b2;
+};
+
+/**
+ * Returns the number of seconds that have passed since a moment
+ * @param start - The moment
+ * @return The seconds since then
+ */
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Builds a tour of some of the points by smallest increase insertion and
+ * improves it with local search
+ * @param points - All the points
+ * @param cities - The cities to visit, in the order to insert them; replaced
+ *                 by the cities in the order the tour visits them
+ * @param deadline - The moment to stop improving by
+ */
+static void solveStrip(const std::vector<Point>& points, std::vector<int>& cities, Deadline deadline)
+{
+    Tour tour;
+    std::vector<Point> stripPoints;
+    stripPoints.reserve(cities.size());
+    for (int city : cities)
+    {
+        tour.insertSmallest(points[city]);
+        stripPoints.push_back(points[city]);
+    }
+
+    // Tour only knows points, so find which city of the strip each of its
+    // points is by looking its coordinates up in a sorted list
+    std::vector<std::pair<std::pair<double, double>, int>> byCoordinates;
+    byCoordinates.reserve(stripPoints.size());
+    for (int i = 0; i < (int) stripPoints.size(); i++)
+    {
+        byCoordinates.push_back(std::make_pair(std::make_pair(stripPoints[i].x, stripPoints[i].y), i));
+    }
+    std::sort(byCoordinates.begin(), byCoordinates.end());
+    std::vector<bool> isUsed(stripPoints.size(), false);
+    std::vector<int> order;
+    order.reserve(stripPoints.size());
+    for (const Point& p : tour.points())
+    {
+        auto it = std::lower_bound(byCoordinates.begin(), byCoordinates.end(),
+                                   std::make_pair(std::make_pair(p.x, p.y), -1));
+        while (isUsed[it->second])
+        {
+            ++it; // A duplicate of a point already placed
+        }
+        isUsed[it->second] = true;
+        order.push_back(it->second);
+    }
+
+    ArrayTour stripTour(stripPoints, order);
+    NeighborLists neighbors(stripTour, NUM_NEIGHBORS);
+    double seconds = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+    optimizeTour(stripTour, neighbors, std::max(0.0, seconds));
+
+    std::vector<int> stripCities(cities);
+    for (int i = 0; i < stripTour.size(); i++)
+    {
+        cities[i] = stripCities[stripTour.city(i)];
+    }
+}
+
+/**
+ * Tries the four ways of joining two tours at a city of each, keeping the
+ * cheapest join found so far
+ * @param points - All the points
+ * @param tour - The first tour
+ * @param i - The position in the first tour of its city to join at
+ * @param strip - The second tour
+ * @param j - The position in the second tour of its city to join at
+ * @param best - The cheapest join found so far
+ */
+static void tryJoins(const std::vector<Point>& points, const std::vector<int>& tour, int i,
+                     const std::vector<int>& strip, int j, Join& best)
+{
+    int n = tour.size();
+    int m = strip.size();
+    int a = tour[i];
+    int b = strip[j];
+    double addedAB = points[a].distanceTo(points[b]);
+    int aSides[2] = { tour[(i + 1) % n], tour[(i + n - 1) % n] };
+    int bSides[2] = { strip[(j + 1) % m], strip[(j + m - 1) % m] };
+
+    for (int a2 : aSides)
+    {
+        for (int b2 : bSides)
+        {
+            double cost = addedAB + points[a2].distanceTo(points[b2])
+                          - points[a].distanceTo(points[a2]) - points[b].distanceTo(points[b2]);
+            if (cost < best.cost)
+            {
+                best = { cost, a, a2, b, b2 };
+            }
+        }
+    }
+}
+
+/**
+ * Merges the tour of a strip into the tour of the strips before it, at the
+ * cheapest pair of edges between a city and one of its neighbors
+ * @param points - All the points
+ * @param neighbors - The neighbor lists of all the points
+ * @param stripOf - The strip of each city
+ * @param tour - The tour of the strips before; replaced by the merged tour
+ * @param strip - The tour of the strip
+ * @param stripIndex - The number of the strip
+ * @param position - The position of each city in the tour of its strip, or
+ *                   in the merged tour once merged; kept up to date
+ */
+static void mergeStrip(const std::vector<Point>& points, const NeighborLists& neighbors,
+                       const std::vector<int>& stripOf, std::vector<int>& tour,
+                       const std::vector<int>& strip, int stripIndex, std::vector<int>& position)
+{
+    Join best = { INFINITY, -1, -1, -1, -1 };
+    for (int i = 0; i < (int) tour.size(); i++)
+    {
+        const int* near = neighbors.of(tour[i]);
+        for (int j = 0; j < neighbors.k(); j++)
+        {
+            if (stripOf[near[j]] == stripIndex)
+            {
+                tryJoins(points, tour, i, strip, position[near[j]], best);
+            }
+        }
+    }
+    if (best.a < 0)
+    {
+        // No city has a neighbor in the strip; join at its first city and
+        // the nearest city of the tour to it
+        int nearest = 0;
+        for (int i = 1; i < (int) tour.size(); i++)
+        {
+            if (points[tour[i]].distanceTo(points[strip[0]]) < points[tour[nearest]].distanceTo(points[strip[0]]))
+            {
+                nearest = i;
+            }
+        }
+        tryJoins(points, tour, nearest, strip, 0, best);
+    }
+
+    // Walk the tour from a2 away from a, then the strip from b away from b2
+    int n = tour.size();
+    int m = strip.size();
+    std::vector<int> merged;
+    merged.reserve(n + m);
+    int i = position[best.a2];
+    int step = tour[(i + 1) % n] == best.a ? n - 1 : 1;
+    for (int count = 0; count < n; count++, i = (i + step) % n)
+    {
+        merged.push_back(tour[i]);
+    }
+    i = position[best.b];
+    step = strip[(i + 1) % m] == best.b2 ? m - 1 : 1;
+    for (int count = 0; count < m; count++, i = (i + step) % m)
+    {
+        merged.push_back(strip[i]);
+    }
+
+    tour.swap(merged);
+    for (int i = 0; i < (int) tour.size(); i++)
+    {
+        position[tour[i]] = i;
+    }
+}
+
+/**
+ * Finds a short tour through points, using several threads
+ * @param points - The points to visit
+ * @param seconds - The time budget
+ * @param numThreads - The number of threads to build and improve strips on
+ * @param progress - The stream to report on, or nullptr
+ * @return The tour
+ */
+ArrayTour solveInParallel(const std::vector<Point>& points, double seconds, int numThreads,
+                          std::ostream* progress)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int n = points.size();
+    if (numThreads <= 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    int numStrips = std::max(1, std::min(numThreads, n / MIN_CITIES_PER_STRIP));
+
+    // Split the cities into strips of equal size by x coordinate, keeping
+    // each strip in input order
+    std::vector<int> byX(n);
+    for (int city = 0; city < n; city++)
+    {
+        byX[city] = city;
+    }
+    std::stable_sort(byX.begin(), byX.end(), [&points](int a, int b) { return points[a].x < points[b].x; });
+    std::vector<std::vector<int>> strips(numStrips);
+    std::vector<int> stripOf(n);
+    for (int s = 0; s < numStrips; s++)
+    {
+        strips[s].assign(byX.begin() + (long) s * n / numStrips, byX.begin() + (long) (s + 1) * n / numStrips);
+        std::sort(strips[s].begin(), strips[s].end());
+        for (int city : strips[s])
+        {
+            stripOf[city] = s;
+        }
+    }
+
+    // Solve the strips on their own threads while this one finds the
+    // neighbor lists of all the cities
+    Deadline stripDeadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(seconds * STRIP_SHARE));
+    std::vector<std::thread> workers;
+    for (int s = 0; s < numStrips; s++)
+    {
+        workers.push_back(std::thread(solveStrip, std::cref(points), std::ref(strips[s]), stripDeadline));
+    }
+    NeighborLists neighbors(ArrayTour(points), NUM_NEIGHBORS);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    if (progress != nullptr)
+    {
+        *progress << "Solved " << numStrips << " strips in " << std::fixed << std::setprecision(3)
+                  << secondsSince(start) << " s" << std::endl;
+    }
+
+    std::vector<int> position(n);
+    for (const std::vector<int>& strip : strips)
+    {
+        for (int i = 0; i < (int) strip.size(); i++)
+        {
+            position[strip[i]] = i;
+        }
+    }
+    std::vector<int> order(strips[0]);
+    for (int s = 1; s < numStrips; s++)
+    {
+        mergeStrip(points, neighbors, stripOf, order, strips[s], s, position);
+    }
+    ArrayTour tour(points, order);
+    if (progress != nullptr)
+    {
+        *progress << "Merged strips, distance " << std::fixed << std::setprecision(4) << tour.distance()
+                  << "   " << std::setprecision(3) << secondsSince(start) << " s" << std::endl;
+    }
+
+    optimizeTour(tour, neighbors, std::max(0.0, seconds - secondsSince(start)), progress);
+    return tour;
+}
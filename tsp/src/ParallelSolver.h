@@ -0,0 +1,30 @@
+/**
+ * Declares a solver that builds and improves a tour on several threads
+ * @file ParallelSolver.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef PARALLELSOLVER_H
+#define PARALLELSOLVER_H
+
+#include <iostream>
+#include <vector>
+#include "ArrayTour.h"
+
+/*
+ * Finds a short tour through the given points without drawing anything.
+ * The points are split by x coordinate into vertical strips of equal size, one
+ * per thread.  Each thread builds a tour of its strip with smallest increase
+ * insertion and improves it with local search for up to half the time budget.
+ * The strip tours are then merged, left to right, each into the tour of the
+ * strips before it by swapping a pair of edges between neighboring cities.
+ * Finally local search runs on the whole tour for the rest of the budget,
+ * which mostly mends the seams between the strips.
+ * With numThreads 0, one thread per hardware thread is used.  Small problems
+ * are given fewer threads so that each strip has enough cities to be worth one.
+ * If progress is not nullptr, each stage is reported on it.
+ */
+ArrayTour solveInParallel(const std::vector<Point>& points, double seconds, int numThreads = 0,
+                          std::ostream* progress = nullptr);
+
+#endif // PARALLELSOLVER_H
@@ -0,0 +1,133 @@
+/**
+ * Defines the PointArray class
+ * @file PointArray.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <cmath>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "PointArray.h"
+
+/**
+ * Copies points into separate arrays of coordinates
+ * @param points - The points; point i of the array is points[i]
+ */
+PointArray::PointArray(const std::vector<Point>& points)
+{
+    reserve(points.size());
+    for (const Point& p : points)
+    {
+        add(p);
+    }
+}
+
+/**
+ * Works out the distance from a point to each of a run of the points
+ * @param p - The point to measure from
+ * @param begin - The first point of the run
+ * @param end - One past the last point of the run
+ * @param distances - Receives the distance to point i at distances[i - begin]
+ */
+void PointArray::distancesFrom(Point p, int begin, int end, double* distances) const
+{
+    const double* xs = _x.data();
+    const double* ys = _y.data();
+    int i = begin;
+
+#if defined(__AVX__)
+    __m256d px4 = _mm256_set1_pd(p.x);
+    __m256d py4 = _mm256_set1_pd(p.y);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), px4);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), py4);
+        __m256d squared = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        _mm256_storeu_pd(distances + i - begin, _mm256_sqrt_pd(squared));
+    }
+#endif
+#if defined(__SSE2__)
+    __m128d px = _mm_set1_pd(p.x);
+    __m128d py = _mm_set1_pd(p.y);
+    for (; i + 2 <= end; i += 2)
+    {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), px);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), py);
+        __m128d squared = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        _mm_storeu_pd(distances + i - begin, _mm_sqrt_pd(squared));
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        double dx = xs[i] - p.x;
+        double dy = ys[i] - p.y;
+        distances[i - begin] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+/**
+ * Works out how much longer a tour gets by putting a point into each of a
+ * run of edges, each from one of these points to the same point of another
+ * array: the distance from the point to both ends minus the length of the edge
+ * @param p - The point to insert
+ * @param ends - The other ends of the edges
+ * @param begin - The first edge of the run
+ * @param end - One past the last edge of the run
+ * @param costs - Receives the cost of edge i at costs[i - begin]
+ */
+void PointArray::insertionCosts(Point p, const PointArray& ends, int begin, int end, double* costs) const
+{
+    const double* ax = _x.data();
+    const double* ay = _y.data();
+    const double* bx = ends._x.data();
+    const double* by = ends._y.data();
+    int i = begin;
+
+#if defined(__AVX__)
+    __m256d px4 = _mm256_set1_pd(p.x);
+    __m256d py4 = _mm256_set1_pd(p.y);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m256d ax4 = _mm256_loadu_pd(ax + i);
+        __m256d ay4 = _mm256_loadu_pd(ay + i);
+        __m256d bx4 = _mm256_loadu_pd(bx + i);
+        __m256d by4 = _mm256_loadu_pd(by + i);
+        __m256d apx = _mm256_sub_pd(ax4, px4), apy = _mm256_sub_pd(ay4, py4);
+        __m256d bpx = _mm256_sub_pd(bx4, px4), bpy = _mm256_sub_pd(by4, py4);
+        __m256d abx = _mm256_sub_pd(ax4, bx4), aby = _mm256_sub_pd(ay4, by4);
+        __m256d ap = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(apx, apx), _mm256_mul_pd(apy, apy)));
+        __m256d bp = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(bpx, bpx), _mm256_mul_pd(bpy, bpy)));
+        __m256d ab = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(abx, abx), _mm256_mul_pd(aby, aby)));
+        _mm256_storeu_pd(costs + i - begin, _mm256_sub_pd(_mm256_add_pd(ap, bp), ab));
+    }
+#endif
+#if defined(__SSE2__)
+    __m128d px = _mm_set1_pd(p.x);
+    __m128d py = _mm_set1_pd(p.y);
+    for (; i + 2 <= end; i += 2)
+    {
+        __m128d ax2 = _mm_loadu_pd(ax + i);
+        __m128d ay2 = _mm_loadu_pd(ay + i);
+        __m128d bx2 = _mm_loadu_pd(bx + i);
+        __m128d by2 = _mm_loadu_pd(by + i);
+        __m128d apx = _mm_sub_pd(ax2, px), apy = _mm_sub_pd(ay2, py);
+        __m128d bpx = _mm_sub_pd(bx2, px), bpy = _mm_sub_pd(by2, py);
+        __m128d abx = _mm_sub_pd(ax2, bx2), aby = _mm_sub_pd(ay2, by2);
+        __m128d ap = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(apx, apx), _mm_mul_pd(apy, apy)));
+        __m128d bp = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(bpx, bpx), _mm_mul_pd(bpy, bpy)));
+        __m128d ab = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(abx, abx), _mm_mul_pd(aby, aby)));
+        _mm_storeu_pd(costs + i - begin, _mm_sub_pd(_mm_add_pd(ap, bp), ab));
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        double apx = ax[i] - p.x, apy = ay[i] - p.y;
+        double bpx = bx[i] - p.x, bpy = by[i] - p.y;
+        double abx = ax[i] - bx[i], aby = ay[i] - by[i];
+        costs[i - begin] = std::sqrt(apx * apx + apy * apy) + std::sqrt(bpx * bpx + bpy * bpy)
+                           - std::sqrt(abx * abx + aby * aby);
+    }
+}
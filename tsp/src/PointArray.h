@@ -0,0 +1,42 @@
+/**
+ * Declares the PointArray class, points stored as separate arrays of coordinates
+ * @file PointArray.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef POINTARRAY_H
+#define POINTARRAY_H
+
+#include <vector>
+#include "Point.h"
+
+/*
+ * Points stored with all their x coordinates in one array and all their y
+ * coordinates in another, rather than as a vector of Point.  This lets the
+ * distances from one point to a run of many be worked out several at a time
+ * with SIMD instructions: four at a time where the compiler targets AVX, two
+ * with SSE2, which every x86-64 processor has, and one by one otherwise.
+ * The results are the same, to the last bit, as Point::distanceTo gives.
+ */
+class PointArray
+{
+public:
+    PointArray() {}
+    PointArray(const std::vector<Point>& points);
+
+    int size() const { return (int) _x.size(); }
+    Point point(int i) const { return Point(_x[i], _y[i]); }
+    void add(Point p) { _x.push_back(p.x); _y.push_back(p.y); }
+    void set(int i, Point p) { _x[i] = p.x; _y[i] = p.y; }
+    void clear() { _x.clear(); _y.clear(); }
+    void reserve(int n) { _x.reserve(n); _y.reserve(n); }
+
+    void distancesFrom(Point p, int begin, int end, double* distances) const;
+    void insertionCosts(Point p, const PointArray& ends, int begin, int end, double* costs) const;
+
+private:
+    std::vector<double> _x;
+    std::vector<double> _y;
+};
+
+#endif // POINTARRAY_H
@@ -0,0 +1,365 @@
+/**
+ * Defines the QuadTree class
+ * @file QuadTree.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "QuadTree.h"
+
+// Number of nodes a leaf square holds before it is split into four; large
+// leaves give the distance kernels of PointArray long runs to work on
+static const int LEAF_CAPACITY = 64;
+
+QuadTree::QuadTree()
+{
+    _root = -1;
+    _size = 0;
+}
+
+/**
+ * Adds a node to the tree, growing the root square and splitting the leaf
+ * square it lands in as needed
+ * @param node - The node to add; must stay alive while it is in the tree
+ */
+void QuadTree::insert(Node* node)
+{
+    Point p = node->point;
+    if (_root < 0)
+    {
+        // From a corner on whole numbers and a side of one, every corner and
+        // side stays a sum of powers of two, so halving and doubling is exact
+        _root = newSquare(std::floor(p.x), std::floor(p.y), 1);
+    }
+    const Square* root = &_squares[_root];
+    while (p.x < root->minX || p.x >= root->minX + root->side
+           || p.y < root->minY || p.y >= root->minY + root->side)
+    {
+        grow(p);
+        root = &_squares[_root];
+    }
+
+    int leaf = leafOf(p);
+    add(leaf, node, node->next->point);
+    _size++;
+    if ((int) _squares[leaf].nodes.size() > _squares[leaf].capacity)
+    {
+        split(leaf);
+    }
+}
+
+/**
+ * Brings the tree up to date after a node has been linked to a new next node
+ * @param node - The node, which must be in the tree
+ */
+void QuadTree::nextChanged(Node* node)
+{
+    Square& leaf = _squares[leafOf(node->point)];
+    int i = std::find(leaf.nodes.begin(), leaf.nodes.end(), node) - leaf.nodes.begin();
+    leaf.nextPoints.set(i, node->next->point);
+}
+
+/**
+ * Removes all nodes from the tree; the nodes themselves are not deleted
+ */
+void QuadTree::clear()
+{
+    _squares.clear();
+    _root = -1;
+    _size = 0;
+}
+
+/**
+ * Finds the node whose point lies nearest to a point
+ * @param p - The point to search around
+ * @return The nearest node, or nullptr if the tree is empty
+ */
+Node* QuadTree::nearest(Point p) const
+{
+    Node* nearestNode = nullptr;
+    double nearestDistance = INFINITY;
+    if (_root >= 0)
+    {
+        nearestIn(_root, p, nearestDistance, nearestNode);
+    }
+    return nearestNode;
+}
+
+/**
+ * Looks for the edge, among those from the nodes of the tree to their next
+ * nodes, whose length grows the least when a point is put into it.  Squares
+ * are skipped that lie so far from the point that none of their edges can do
+ * better than the best found so far; this takes a bound on the length of the
+ * edges, and any edge longer than it must be checked by the caller
+ * @param p - The point to insert
+ * @param longestEdge - The length that no edge left to the tree is longer than
+ * @param smallestIncrease - The smallest growth found so far; lowered if an
+ *                           edge of the tree grows less
+ * @param bestNode - The first node of the edge that grows the least so far;
+ *                   replaced along with smallestIncrease
+ */
+void QuadTree::cheapestInsertion(Point p, double longestEdge, double& smallestIncrease, Node*& bestNode) const
+{
+    if (_root >= 0)
+    {
+        cheapestInsertionIn(_root, p, longestEdge, smallestIncrease, bestNode);
+    }
+}
+
+/**
+ * Adds an empty leaf square to the tree
+ * @param minX - The left edge of the square
+ * @param minY - The bottom edge of the square
+ * @param side - The length of its sides
+ * @return The index of the square
+ */
+int QuadTree::newSquare(double minX, double minY, double side)
+{
+    Square square;
+    square.minX = minX;
+    square.minY = minY;
+    square.side = side;
+    std::fill(square.children, square.children + 4, -1);
+    square.capacity = LEAF_CAPACITY;
+    _squares.push_back(square);
+    return _squares.size() - 1;
+}
+
+/**
+ * Returns which quarter of a square a point lies in
+ * @param square - The square
+ * @param p - The point, which must lie in the square
+ * @return The index of the child square that holds the point
+ */
+int QuadTree::quadrantOf(const Square& square, Point p) const
+{
+    double half = square.side / 2;
+    return (p.x >= square.minX + half) + 2 * (p.y >= square.minY + half);
+}
+
+/**
+ * Finds the leaf square a point lies in
+ * @param p - The point, which must lie in the root square
+ * @return The index of the leaf
+ */
+int QuadTree::leafOf(Point p) const
+{
+    int index = _root;
+    while (!_squares[index].isLeaf())
+    {
+        index = _squares[index].children[quadrantOf(_squares[index], p)];
+    }
+    return index;
+}
+
+/**
+ * Puts a node into a leaf square
+ * @param leaf - The index of the leaf
+ * @param node - The node
+ * @param next - The point of the node after it
+ */
+void QuadTree::add(int leaf, Node* node, Point next)
+{
+    Square& square = _squares[leaf];
+    square.nodes.push_back(node);
+    square.points.add(node->point);
+    square.nextPoints.add(next);
+}
+
+/**
+ * Splits a leaf square into four and moves its nodes down into them,
+ * splitting those in turn if need be.  A leaf whose points are all the same,
+ * or too close to tell apart, is left whole to hold twice as many nodes
+ * @param leaf - The index of the leaf
+ */
+void QuadTree::split(int leaf)
+{
+    Square& square = _squares[leaf];
+    double half = square.side / 2;
+    bool isSplittable = square.minX + half > square.minX && square.minY + half > square.minY;
+    bool isAllSame = true;
+    Point first = square.points.point(0);
+    for (int i = 1; isAllSame && i < square.points.size(); i++)
+    {
+        Point other = square.points.point(i);
+        isAllSame = other.x == first.x && other.y == first.y;
+    }
+    if (!isSplittable || isAllSame)
+    {
+        square.capacity *= 2;
+        return;
+    }
+
+    std::vector<Node*> nodes;
+    PointArray nextPoints;
+    nodes.swap(square.nodes);
+    std::swap(nextPoints, square.nextPoints);
+    square.points.clear();
+    double minX = square.minX;
+    double minY = square.minY;
+    for (int quadrant = 0; quadrant < 4; quadrant++)
+    {
+        int child = newSquare(minX + (quadrant % 2) * half, minY + (quadrant / 2) * half, half);
+        _squares[leaf].children[quadrant] = child;
+    }
+
+    for (int i = 0; i < (int) nodes.size(); i++)
+    {
+        add(_squares[leaf].children[quadrantOf(_squares[leaf], nodes[i]->point)], nodes[i], nextPoints.point(i));
+    }
+    for (int quadrant = 0; quadrant < 4; quadrant++)
+    {
+        int child = _squares[leaf].children[quadrant];
+        if ((int) _squares[child].nodes.size() > _squares[child].capacity)
+        {
+            split(child);
+        }
+    }
+}
+
+/**
+ * Doubles the root square towards a point outside it, making the old root
+ * one of the four children of the new one
+ * @param p - The point
+ */
+void QuadTree::grow(Point p)
+{
+    int oldRoot = _root;
+    double side = _squares[oldRoot].side;
+    double minX = _squares[oldRoot].minX;
+    double minY = _squares[oldRoot].minY;
+    int oldQuadrant = 0;
+    if (p.x < minX)
+    {
+        minX -= side;
+        oldQuadrant += 1;
+    }
+    if (p.y < minY)
+    {
+        minY -= side;
+        oldQuadrant += 2;
+    }
+
+    _root = newSquare(minX, minY, 2 * side);
+    for (int quadrant = 0; quadrant < 4; quadrant++)
+    {
+        int child = quadrant == oldQuadrant ? oldRoot
+                    : newSquare(minX + (quadrant % 2) * side, minY + (quadrant / 2) * side, side);
+        _squares[_root].children[quadrant] = child;
+    }
+}
+
+/**
+ * Returns the distance from a point to the nearest point of a square
+ * @param square - The square
+ * @param p - The point
+ * @return The distance, 0 if the point lies in the square
+ */
+double QuadTree::distanceTo(const Square& square, Point p) const
+{
+    double dx = std::max(std::max(square.minX - p.x, p.x - (square.minX + square.side)), 0.0);
+    double dy = std::max(std::max(square.minY - p.y, p.y - (square.minY + square.side)), 0.0);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/**
+ * Orders the children of a square by their distance to a point
+ * @param square - The square, which must not be a leaf
+ * @param p - The point
+ * @param order - Receives the indices of the children, nearest first
+ * @param distances - Receives their distances to the point, in the same order
+ */
+void QuadTree::childrenByDistance(const Square& square, Point p, int order[4], double distances[4]) const
+{
+    for (int i = 0; i < 4; i++)
+    {
+        order[i] = square.children[i];
+        distances[i] = distanceTo(_squares[order[i]], p);
+        for (int j = i; j > 0 && distances[j] < distances[j - 1]; j--)
+        {
+            std::swap(distances[j], distances[j - 1]);
+            std::swap(order[j], order[j - 1]);
+        }
+    }
+}
+
+/**
+ * Finds the node nearest to a point among those in a square, if any is
+ * nearer than the nearest found so far
+ * @param index - The index of the square
+ * @param p - The point to search around
+ * @param nearestDistance - The distance to the nearest node found so far;
+ *                          lowered if a nearer one is found
+ * @param nearestNode - The nearest node found so far; replaced along with
+ *                      nearestDistance
+ */
+void QuadTree::nearestIn(int index, Point p, double& nearestDistance, Node*& nearestNode) const
+{
+    const Square& square = _squares[index];
+    if (square.isLeaf())
+    {
+        int count = square.nodes.size();
+        _distances.resize(std::max((int) _distances.size(), count));
+        square.points.distancesFrom(p, 0, count, _distances.data());
+        for (int i = 0; i < count; i++)
+        {
+            if (_distances[i] < nearestDistance)
+            {
+                nearestDistance = _distances[i];
+                nearestNode = square.nodes[i];
+            }
+        }
+        return;
+    }
+
+    int order[4];
+    double distances[4];
+    childrenByDistance(square, p, order, distances);
+    for (int i = 0; i < 4 && distances[i] < nearestDistance; i++)
+    {
+        nearestIn(order[i], p, nearestDistance, nearestNode);
+    }
+}
+
+/**
+ * Looks for a cheaper edge to insert a point into among those from the nodes
+ * in a square.  An edge from a node at least r from the point and at most
+ * longestEdge long grows by at least 2 * (r - longestEdge), which rules out
+ * the squares that lie too far away
+ * @param index - The index of the square
+ * @param p - The point to insert
+ * @param longestEdge - The length that no edge left to the tree is longer than
+ * @param smallestIncrease - The smallest growth found so far; lowered if an
+ *                           edge of the square grows less
+ * @param bestNode - The first node of the edge that grows the least so far;
+ *                   replaced along with smallestIncrease
+ */
+void QuadTree::cheapestInsertionIn(int index, Point p, double longestEdge,
+                                   double& smallestIncrease, Node*& bestNode) const
+{
+    const Square& square = _squares[index];
+    if (square.isLeaf())
+    {
+        int count = square.nodes.size();
+        _distances.resize(std::max((int) _distances.size(), count));
+        square.points.insertionCosts(p, square.nextPoints, 0, count, _distances.data());
+        for (int i = 0; i < count; i++)
+        {
+            if (smallestIncrease > _distances[i])
+            {
+                smallestIncrease = _distances[i];
+                bestNode = square.nodes[i];
+            }
+        }
+        return;
+    }
+
+    int order[4];
+    double distances[4];
+    childrenByDistance(square, p, order, distances);
+    for (int i = 0; i < 4 && 2 * (distances[i] - longestEdge) < smallestIncrease; i++)
+    {
+        cheapestInsertionIn(order[i], p, longestEdge, smallestIncrease, bestNode);
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * Declares the QuadTree class, a quadtree over the nodes of a tour
+ * @file QuadTree.h
+ * @authors vikho305 & isaho220
+ */
+
+#ifndef QUADTREE_H
+#define QUADTREE_H
+
+#include <vector>
+#include "Node.h"
+#include "Point.h"
+#include "PointArray.h"
+
+/*
+ * Buckets the nodes of a tour by the square of the plane their point lies in,
+ * so that the nodes near a point can be found without looking at all of them.
+ * The squares form a quadtree: a square that holds more than a few dozen
+ * nodes is split into four, so squares are small where the points are dense
+ * and large where they are sparse.  A search only goes down into squares that
+ * can hold a better node than the best found so far, nearest first, so it
+ * takes about logarithmic time however the points are spread, be they in tight
+ * clusters with a far outlier or evenly over the plane.  The root square
+ * doubles in size whenever a node falls outside it.
+ * Each leaf square also keeps the points of its nodes and of the nodes after
+ * them in PointArrays, so that searching it works out all its distances at
+ * once without following a pointer per node; the tour must call nextChanged
+ * whenever it links a node to a new next node.
+ */
+class QuadTree
+{
+public:
+    QuadTree();
+
+    int size() const { return _size; }
+    void insert(Node* node);
+    void nextChanged(Node* node);
+    void clear();
+
+    Node* nearest(Point p) const;
+    void cheapestInsertion(Point p, double longestEdge, double& smallestIncrease, Node*& bestNode) const;
+
+private:
+    /*
+     * A square of the tree: either split into four children, or a leaf
+     * holding the nodes in it, with their points and the points of their next
+     * nodes.
+     */
+    struct Square
+    {
+        double minX, minY;      // lower left corner
+        double side;
+        int children[4];        // lower left, lower right, upper left, upper right; -1 in a leaf
+        int capacity;           // nodes a leaf holds before it is split
+        std::vector<Node*> nodes;
+        PointArray points;
+        PointArray nextPoints;
+
+        bool isLeaf() const { return children[0] < 0; }
+    };
+
+    std::vector<Square> _squares;
+    int _root;
+    int _size;
+    mutable std::vector<double> _distances; // scratch space for the searches
+
+    int newSquare(double minX, double minY, double side);
+    int quadrantOf(const Square& square, Point p) const;
+    int leafOf(Point p) const;
+    void add(int leaf, Node* node, Point next);
+    void split(int leaf);
+    void grow(Point p);
+    double distanceTo(const Square& square, Point p) const;
+    void nearestIn(int index, Point p, double& nearestDistance, Node*& nearestNode) const;
+    void cheapestInsertionIn(int index, Point p, double longestEdge,
+                             double& smallestIncrease, Node*& bestNode) const;
+    void childrenByDistance(const Square& square, Point p, int order[4], double distances[4]) const;
+};
+
+#endif // QUADTREE_H
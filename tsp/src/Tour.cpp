@@ -4,22 +4,49 @@
  * @authors vikho305 & isaho220
  */
 
+#include <cassert>
+#include <cmath>
 #include <iostream>
 #include "Tour.h"
 #include "Node.h"
 #include "Point.h"
 
+// Number of the longest edges insertSmallest checks before searching near the point
+static const int LONG_EDGES_CHECKED = 16;
+
 Tour::Tour()
 {
     _startNode = nullptr;
+    _size = 0;
+    _distance = 0;
+}
+
+/**
+ * Makes a tour that visits points in a given order, such as one of the
+ * heuristics in Construction.h returns
+ * @param points - The points of the tour
+ * @param order - The indices of the points in the order to visit them
+ */
+Tour::Tour(const std::vector<Point>& points, const std::vector<int>& order)
+{
+    _startNode = nullptr;
+    _size = 0;
+    _distance = 0;
+
+    // Each point goes between the one before it and the first
+    Node* lastNode = nullptr;
+    for (int i : order)
+    {
+        insertAfter(lastNode, points[i]);
+        lastNode = lastNode == nullptr ? _startNode : lastNode->next;
+    }
 }
 
 Tour::~Tour()
 {
     Node* currentNode = _startNode;
-    int currentSize = size();
 
-    for (int i = 0; i < currentSize; i++)
+    for (int i = 0; i < _size; i++)
     {
         Node* nextNode = currentNode->next;
         delete currentNode;
@@ -66,38 +93,55 @@ void Tour::draw(QGraphicsScene *scene)
  */
 int Tour::size()
 {
-    int size = 0;
+    return _size;
+}
 
+/**
+ * Returns the sum of the distance between all neighbouring nodes in the tour,
+ * which is kept as the tour grows
+ * @return The sum of all distances between neighbouring nodes
+ */
+double Tour::distance()
+{
+    return _distance;
+}
+
+/**
+ * Checks, unless NDEBUG is defined, that the distance kept as the tour grows
+ * matches the distance summed over the whole tour, up to rounding
+ */
+void Tour::checkDistance()
+{
+#ifndef NDEBUG
+    double distance = 0;
     Node* currentNode = _startNode;
-    do
+    for (int i = 0; i < _size; i++)
     {
-        size++;
+        distance += currentNode->point.distanceTo(currentNode->next->point);
         currentNode = currentNode->next;
     }
-    while(currentNode != _startNode);
-
-    return size;
+    assert(std::fabs(distance - _distance) <= 1e-9 * std::max(1.0, distance));
+#endif
 }
 
 /**
- * Returns the sum of the distance between all neighbouring nodes in the tour
- * @return The sum of all distances between neighbouring nodes
+ * Returns the points of the tour in the order it visits them, starting with
+ * the first point inserted, for building an ArrayTour
+ * @return The points of the tour
  */
-double Tour::distance()
+std::vector<Point> Tour::points()
 {
-    double distance = 0;
+    std::vector<Point> points;
+    points.reserve(_size);
 
     Node* currentNode = _startNode;
-    do
+    for (int i = 0; i < _size; i++)
     {
-        Node* nextNode = currentNode->next;
-        distance += currentNode->point.distanceTo(nextNode->point);
-        currentNode = nextNode;
-
+        points.push_back(currentNode->point);
+        currentNode = currentNode->next;
     }
-    while(currentNode != _startNode);
 
-    return distance;
+    return points;
 }
 
 /**
@@ -108,32 +152,11 @@ void Tour::insertNearest(Point p)
 {
     if (_startNode != nullptr)
     {
-        Node* nearestNode = _startNode;
-        double nearestDistance = -1;
-
-        Node* currentNode = _startNode;
-        do
-        {
-            double distance = currentNode->point.distanceTo(p);
-            if (nearestDistance < 0 || nearestDistance > distance)
-            {
-                nearestDistance = distance;
-                nearestNode = currentNode;
-            }
-
-            currentNode = currentNode->next;
-
-        }
-        while(currentNode != _startNode);
-
-        Node* nextNode = nearestNode->next;
-        nearestNode->next = new Node(p);
-        nearestNode->next->next = nextNode;
+        insertAfter(_tree.nearest(p), p);
     }
     else
     {
-        _startNode = new Node(p);
-        _startNode->next = _startNode;
+        insertAfter(nullptr, p);
     }
 }
 
@@ -146,30 +169,63 @@ void Tour::insertSmallest(Point p)
     if (_startNode != nullptr)
     {
         Node* nearestNode = _startNode;
-        double smallestIncrease = -1;
+        double smallestIncrease = INFINITY;
 
-        Node* currentNode = _startNode;
-        do
+        // The longest edges are checked first, one by one
+        std::set<std::pair<double, Node*>>::reverse_iterator edge = _edges.rbegin();
+        for (int i = 0; i < LONG_EDGES_CHECKED && edge != _edges.rend(); i++, edge++)
         {
-            double originalDist = currentNode->point.distanceTo(currentNode->next->point);
-            double distance = currentNode->point.distanceTo(p) + currentNode->next->point.distanceTo(p);
-            if (smallestIncrease < 0 || smallestIncrease > distance - originalDist)
+            Node* currentNode = edge->second;
+            double increase = currentNode->point.distanceTo(p) + currentNode->next->point.distanceTo(p) - edge->first;
+            if (smallestIncrease > increase)
             {
-                smallestIncrease = distance - originalDist;
+                smallestIncrease = increase;
                 nearestNode = currentNode;
             }
-
-            currentNode = currentNode->next;
         }
-        while(currentNode != _startNode);
 
-        Node* nextNode = nearestNode->next;
-        nearestNode->next = new Node(p);
-        nearestNode->next->next = nextNode;
+        // Any other edge is at most longestEdge long, which lets the search
+        // of the tree skip the squares too far away to hold a cheaper one
+        double longestEdge = edge != _edges.rend() ? edge->first : 0;
+        _tree.cheapestInsertion(p, longestEdge, smallestIncrease, nearestNode);
+
+        insertAfter(nearestNode, p);
     }
     else
     {
-        _startNode = new Node(p);
+        insertAfter(nullptr, p);
+    }
+}
+
+/**
+ * Links a new node for a point into the tour and into the spatial index
+ * @param node - The node to insert the point after, nullptr if the tour is empty
+ * @param p - The point to insert
+ */
+void Tour::insertAfter(Node* node, Point p)
+{
+    Node* newNode = new Node(p);
+    if (node == nullptr)
+    {
+        _startNode = newNode;
         _startNode->next = _startNode;
+        _edges.insert(std::make_pair(0.0, newNode));
+    }
+    else
+    {
+        Node* nextNode = node->next;
+        node->next = newNode;
+        newNode->next = nextNode;
+
+        double removed = node->point.distanceTo(nextNode->point);
+        double addedBefore = node->point.distanceTo(p);
+        double addedAfter = p.distanceTo(nextNode->point);
+        _edges.erase(std::make_pair(removed, node));
+        _edges.insert(std::make_pair(addedBefore, node));
+        _edges.insert(std::make_pair(addedAfter, newNode));
+        _distance += addedBefore + addedAfter - removed;
+        _tree.nextChanged(node);
     }
+    _tree.insert(newNode);
+    _size++;
 }
@@ -7,22 +7,41 @@
 #ifndef TOUR_H
 #define TOUR_H
 
+#include <set>
+#include <vector>
 #include "Node.h"
 #include "Point.h"
+#include "QuadTree.h"
 
+/*
+ * A tour through points in the plane, stored as a circular linked list of
+ * nodes.  The nodes are also kept in a QuadTree, and the edges of the
+ * tour in a set ordered by length, so that the insertion heuristics only look
+ * at the part of the tour near the point being inserted.  The distance of
+ * the tour is kept up to date as points are inserted, so reading it is free.
+ */
 class Tour {
 public:
     Tour();
+    Tour(const std::vector<Point>& points, const std::vector<int>& order);
     ~Tour();
     void show();
     void draw(QGraphicsScene* scene);
     int size();
     double distance();
+    void checkDistance();
     void insertNearest(Point p);
     void insertSmallest(Point p);
+    std::vector<Point> points();
 
 private:
     Node* _startNode;
+    int _size;
+    double _distance;   // kept up to date by insertAfter
+    QuadTree _tree;
+    std::set<std::pair<double, Node*>> _edges;   // length and first node of each edge
+
+    void insertAfter(Node* node, Point p);
 };
 
 #endif // TOUR_H
@@ -0,0 +1,480 @@
+/**
+ * Headless benchmark of the tour heuristics on the point files in res/.
+ * Builds a tour of every file with every chosen heuristic, improves it with
+ * local search, and reports the length and time of both steps and the peak
+ * memory.  Every tour is checked to visit each point exactly once, and the
+ * length it keeps as it changes against one summed over the tour, both as
+ * built and after local search.  Where
+ * res/ has answers for a file, the lengths are checked against them too: the
+ * nearest and smallest insertion tours must match <file>-nearest.ans and
+ * <file>-smallest.ans exactly, and no tour may beat <file>-optimal.ans, which
+ * also gives the gap to the optimum.
+ * It opens no window, but Point still draws with Qt, so build it from src/
+ * together with every .cpp file there except tsp.cpp, against QtWidgets.
+ *
+ * Usage: tspbench [-h heuristic,...] [-t seconds] [-j threads] [-csv] file...
+ * Heuristics: nearest, smallest, hilbert, greedy, mst, parallel.  The local
+ * search is given the time budget of -t, 10 seconds by default, and skipped
+ * with -t 0.  parallel is solveInParallel on -j threads, every hardware thread
+ * by default, which improves the tour itself within the same budget, so its
+ * build time includes the local search.  Everything but the local search, which
+ * stops on time, gives the same tours on every run.
+ * @file tspbench.cpp
+ * @authors vikho305 & isaho220
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "ArrayTour.h"
+#include "Construction.h"
+#include "LocalSearch.h"
+#include "NeighborLists.h"
+#include "ParallelSolver.h"
+#include "Point.h"
+#include "Tour.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+ * The settings given on the command line.
+ */
+struct Options
+{
+    std::vector<std::string> heuristics;    // empty to run them all
+    double seconds = 10;
+    int numThreads = 0;
+    bool csv = false;
+    std::vector<std::string> files;
+};
+
+/*
+ * The measurements of one heuristic on one file.
+ */
+struct Result
+{
+    double buildMs = 0;
+    double builtLength = 0;
+    double optimizeMs = 0;
+    double length = 0;
+    std::string check;      // "ok", or what was wrong
+};
+
+static const char* const HEURISTICS[] = { "nearest", "smallest", "hilbert", "greedy", "mst", "parallel" };
+static const int NUM_HEURISTICS = 6;
+
+// Number of neighbors per city the local search looks at
+static const int NUM_NEIGHBORS = 8;
+
+// Relative difference allowed between a length and the answer file's
+static const double TOLERANCE = 1e-9;
+
+/**
+ * Gives the peak memory use of the process so far
+ * @return The peak resident set size in megabytes, 0 where it is unknown
+ */
+static double peakMemoryMB()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+#endif
+}
+
+/**
+ * Gives the time passed since a point in time
+ * @param start - The point in time
+ * @return The time in milliseconds
+ */
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * Reads the points of a file: its width and height, then x and y of each point
+ * @param filename - The file
+ * @param points - Receives the points
+ * @return False if the file could not be opened
+ */
+static bool readPoints(const std::string& filename, std::vector<Point>& points)
+{
+    std::ifstream input(filename);
+    int width;
+    int height;
+    if (!(input >> width >> height))
+    {
+        return false;
+    }
+    double x;
+    double y;
+    while (input >> x >> y)
+    {
+        points.push_back(Point(x, y));
+    }
+    return true;
+}
+
+/**
+ * Reads the length of the tour in an answer file, which is the last number
+ * on a line starting with the given label
+ * @param filename - The answer file
+ * @param label - The text before the length, such as "Tour distance ="
+ * @param length - Receives the length
+ * @return False if the file does not exist or has no such line
+ */
+static bool readAnswer(const std::string& filename, const std::string& label, double& length)
+{
+    std::ifstream input(filename);
+    std::string line;
+    bool found = false;
+    while (std::getline(input, line))
+    {
+        if (line.compare(0, label.size(), label) == 0)
+        {
+            std::istringstream(line.substr(label.size())) >> length;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * Tells whether a tour visits exactly the given points, each once
+ * @param tour - The tour
+ * @param points - The points
+ * @return True if it does
+ */
+static bool visitsAll(const ArrayTour& tour, const std::vector<Point>& points)
+{
+    std::vector<std::pair<double, double>> expected;
+    std::vector<std::pair<double, double>> visited;
+    for (const Point& p : points)
+    {
+        expected.push_back(std::make_pair(p.x, p.y));
+    }
+    for (const Point& p : tour.points())
+    {
+        visited.push_back(std::make_pair(p.x, p.y));
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(visited.begin(), visited.end());
+    return expected == visited;
+}
+
+/**
+ * Sums the distances between neighbouring points of a tour one by one, to
+ * check the distance the tour keeps as it changes
+ * @param tour - The tour
+ * @return The length of the tour
+ */
+static double summedDistance(const ArrayTour& tour)
+{
+    std::vector<Point> visited = tour.points();
+    double length = 0;
+    for (int i = 0; i < (int) visited.size(); i++)
+    {
+        length += visited[i].distanceTo(visited[(i + 1) % visited.size()]);
+    }
+    return length;
+}
+
+/**
+ * Tells whether a length matches an expected one up to rounding
+ * @param length - The length
+ * @param expected - The expected length
+ * @return True if they match
+ */
+static bool matches(double length, double expected)
+{
+    return std::fabs(length - expected) <= TOLERANCE * std::max(1.0, std::fabs(expected));
+}
+
+/**
+ * Builds a tour of points with a heuristic
+ * @param heuristic - The name of the heuristic
+ * @param points - The points, in file order
+ * @param options - The settings given on the command line
+ * @param keptLength - Receives the length the heuristic kept as it built the
+ *                     tour, to be checked against the length of the tour
+ * @return The tour
+ */
+static ArrayTour build(const std::string& heuristic, const std::vector<Point>& points, const Options& options,
+                       double& keptLength)
+{
+    if (heuristic == "nearest" || heuristic == "smallest")
+    {
+        Tour tour;
+        for (const Point& p : points)
+        {
+            if (heuristic == "nearest")
+                tour.insertNearest(p);
+            else
+                tour.insertSmallest(p);
+        }
+        tour.checkDistance();
+        keptLength = tour.distance();
+        return ArrayTour(tour.points());
+    }
+    if (heuristic == "parallel")
+    {
+        ArrayTour tour = solveInParallel(points, options.seconds, options.numThreads);
+        keptLength = tour.distance();
+        return tour;
+    }
+
+    std::vector<int> order;
+    if (heuristic == "hilbert")
+        order = hilbertOrder(points);
+    else if (heuristic == "greedy")
+        order = greedyEdgeOrder(points);
+    else
+        order = spanningTreeOrder(points);
+    ArrayTour tour(points, order);
+    keptLength = tour.distance();
+    return tour;
+}
+
+/**
+ * Builds and improves a tour with one heuristic, and checks it
+ * @param heuristic - The name of the heuristic
+ * @param points - The points, in file order
+ * @param stem - The file name without its extension, to find answers by
+ * @param options - The settings given on the command line
+ * @return The measurements
+ */
+static Result runHeuristic(const std::string& heuristic, const std::vector<Point>& points,
+                           const std::string& stem, const Options& options)
+{
+    Result result;
+    Clock::time_point buildStart = Clock::now();
+    double keptLength;
+    ArrayTour tour = build(heuristic, points, options, keptLength);
+    result.buildMs = millisecondsSince(buildStart);
+    result.builtLength = tour.distance();
+    double builtSum = summedDistance(tour);
+
+    if (options.seconds > 0 && heuristic != "parallel")
+    {
+        Clock::time_point optimizeStart = Clock::now();
+        NeighborLists neighbors(tour, NUM_NEIGHBORS);
+        optimizeTour(tour, neighbors, options.seconds);
+        result.optimizeMs = millisecondsSince(optimizeStart);
+    }
+    result.length = tour.distance();
+
+    double answer;
+    result.check = "ok";
+    if (!visitsAll(tour, points))
+    {
+        result.check = "not a tour";
+    }
+    else if (!matches(keptLength, builtSum) || !matches(result.length, summedDistance(tour)))
+    {
+        result.check = "distance drifted";
+    }
+    else if (readAnswer(stem + "-" + heuristic + ".ans", "Tour distance =", answer)
+             && !matches(result.builtLength, answer))
+    {
+        result.check = "differs from answer";
+    }
+    else if (readAnswer(stem + "-optimal.ans", "Distance =", answer)
+             && result.length < answer && !matches(result.length, answer))
+    {
+        result.check = "beats optimum";
+    }
+    return result;
+}
+
+/**
+ * Prints the header of the report
+ * @param report - The stream to print to
+ * @param csv - If true, prints comma-separated values instead of a table
+ */
+static void printHeader(std::ostream& report, bool csv)
+{
+    if (csv)
+    {
+        report << "file,heuristic,points,build_ms,built_length,optimize_ms,length,gap_percent,peak_mb,check"
+               << std::endl;
+    }
+    else
+    {
+        report << std::left << std::setw(18) << "file" << std::setw(10) << "heuristic" << std::right
+               << std::setw(8) << "points" << std::setw(11) << "build ms" << std::setw(14) << "built"
+               << std::setw(11) << "opt ms" << std::setw(14) << "length" << std::setw(8) << "gap %"
+               << std::setw(9) << "peak MB" << "  check" << std::endl;
+    }
+}
+
+/**
+ * Prints the measurements of one heuristic on one file
+ * @param report - The stream to print to
+ * @param csv - If true, prints comma-separated values instead of a table
+ * @param file - The name of the file
+ * @param heuristic - The heuristic measured
+ * @param numPoints - The number of points in the file
+ * @param result - The measurements
+ * @param optimum - The length of the optimal tour, or 0 if not known
+ */
+static void printResult(std::ostream& report, bool csv, const std::string& file, const std::string& heuristic,
+                        int numPoints, const Result& result, double optimum)
+{
+    std::string gap = "-";
+    if (optimum > 0)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2) << 100 * (result.length / optimum - 1);
+        gap = text.str();
+    }
+
+    report << std::fixed;
+    if (csv)
+    {
+        report << file << "," << heuristic << "," << numPoints << "," << std::setprecision(1) << result.buildMs
+               << "," << std::setprecision(4) << result.builtLength << "," << std::setprecision(1)
+               << result.optimizeMs << "," << std::setprecision(4) << result.length << "," << gap << ","
+               << std::setprecision(1) << peakMemoryMB() << "," << result.check << std::endl;
+    }
+    else
+    {
+        report << std::left << std::setw(18) << file << std::setw(10) << heuristic << std::right
+               << std::setw(8) << numPoints << std::setprecision(1) << std::setw(11) << result.buildMs
+               << std::setprecision(2) << std::setw(14) << result.builtLength
+               << std::setprecision(1) << std::setw(11) << result.optimizeMs
+               << std::setprecision(2) << std::setw(14) << result.length << std::setw(8) << gap
+               << std::setprecision(1) << std::setw(9) << peakMemoryMB() << "  " << result.check << std::endl;
+    }
+}
+
+/**
+ * Loads a point file and benchmarks the chosen heuristics on it
+ * @param filename - The point file
+ * @param options - The settings given on the command line
+ * @param report - The stream to print the measurements to
+ * @return False if the file could not be loaded or a check failed
+ */
+static bool benchmarkFile(const std::string& filename, const Options& options, std::ostream& report)
+{
+    std::vector<Point> points;
+    if (!readPoints(filename, points))
+    {
+        std::cerr << filename << " is not a valid point file." << std::endl;
+        return false;
+    }
+
+    std::string name = filename.substr(filename.find_last_of("/\\") + 1);
+    std::string stem = filename.substr(0, filename.find_last_of('.'));
+    double optimum = 0;
+    readAnswer(stem + "-optimal.ans", "Distance =", optimum);
+
+    std::vector<std::string> heuristics = options.heuristics;
+    if (heuristics.empty())
+    {
+        heuristics.assign(HEURISTICS, HEURISTICS + NUM_HEURISTICS);
+    }
+
+    bool allPassed = true;
+    for (const std::string& heuristic : heuristics)
+    {
+        Result result = runHeuristic(heuristic, points, stem, options);
+        printResult(report, options.csv, name, heuristic, points.size(), result, optimum);
+        allPassed = allPassed && result.check == "ok";
+    }
+    return allPassed;
+}
+
+/**
+ * Reads the command line
+ * @param argc - The number of arguments
+ * @param argv - The arguments
+ * @param options - Receives the settings
+ * @return False if the command line is not valid
+ */
+static bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-h" && hasValue)
+        {
+            std::istringstream names(argv[++i]);
+            std::string name;
+            while (std::getline(names, name, ','))
+            {
+                if (std::find(HEURISTICS, HEURISTICS + NUM_HEURISTICS, name) == HEURISTICS + NUM_HEURISTICS)
+                {
+                    std::cerr << "Unknown heuristic " << name << std::endl;
+                    return false;
+                }
+                options.heuristics.push_back(name);
+            }
+        }
+        else if ((arg == "-t" || arg == "-j") && hasValue)
+        {
+            std::istringstream value(argv[++i]);
+            double number;
+            value >> number;
+            if (value.fail() || !value.eof() || number < 0)
+            {
+                return false;
+            }
+            if (arg == "-t")
+                options.seconds = number;
+            else
+                options.numThreads = (int) number;
+        }
+        else if (arg == "-csv")
+        {
+            options.csv = true;
+        }
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            options.files.push_back(arg);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !options.files.empty();
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0] << " [-h heuristic,...] [-t seconds] [-j threads] [-csv] file..."
+                  << std::endl;
+        std::cerr << "Heuristics: nearest, smallest, hilbert, greedy, mst, parallel" << std::endl;
+        return 1;
+    }
+
+    printHeader(std::cout, options.csv);
+    bool allPassed = true;
+    for (const std::string& filename : options.files)
+    {
+        allPassed = benchmarkFile(filename, options, std::cout) && allPassed;
+    }
+    return allPassed ? 0 : 1;
+}
@@ -7,18 +7,31 @@
 #include <QApplication>
 #include <QGraphicsView>
 #include <QGraphicsScene>
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <thread>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include "ArrayTour.h"
+#include "LocalSearch.h"
+#include "NeighborLists.h"
 #include "Point.h"
 #include "Tour.h"
 
+// seconds of local search when none are given on the command line
+static const double DEFAULT_SECONDS = 2.0;
+
+// seconds the local search runs between two redraws of the window
+static const double SECONDS_PER_ROUND = 0.25;
+
 int main(int argc, char *argv[]) {
     QApplication a(argc, argv);
 
-    string filename = "tsp10.txt";
+    // the file to read, and the seconds of local search, may be given on the command line
+    string filename = argc > 1 ? argv[1] : "tsp10.txt";
+    double seconds = argc > 2 ? atof(argv[2]) : DEFAULT_SECONDS;
     ifstream input;
     input.open(filename);
 
@@ -51,13 +64,35 @@ int main(int argc, char *argv[]) {
     }
     input.close();
 
+    // improve the finished tour with local search, which works on its array
+    // form, for at most the given number of seconds; it runs in short rounds,
+    // redrawing the tour and handling events in between so that the window
+    // keeps responding, until a round no longer shortens the tour
+    ArrayTour arrayTour(tour.points());
+    cout << "Tour distance after insertion: " << std::fixed << std::setprecision(4)
+         << std::showpoint << arrayTour.distance() << endl;
+    NeighborLists neighbors(arrayTour, 8);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double remaining = seconds;
+    double distance = arrayTour.distance();
+    while (remaining > 0) {
+        double improved = optimizeTour(arrayTour, neighbors, std::min(remaining, SECONDS_PER_ROUND), &cout);
+        arrayTour.draw(scene);
+        a.processEvents();
+        if (improved == distance) {
+            break;
+        }
+        distance = improved;
+        remaining = seconds - std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
     // print tour to standard output
     cout << "Tour distance: " << std::fixed << std::setprecision(4)
-         << std::showpoint << tour.distance() << endl;
-    cout << "Number of points: " << tour.size() << endl;
-    tour.show();
+         << std::showpoint << arrayTour.distance() << endl;
+    cout << "Number of points: " << arrayTour.size() << endl;
+    arrayTour.show();
 
     // draw tour
-    tour.draw(scene);
+    arrayTour.draw(scene);
     return a.exec(); // start Qt event loop
 }